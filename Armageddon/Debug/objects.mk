@@ -4,4 +4,4 @@
 
 USER_OBJS :=
 
-LIBS := -lX11 -lm -lglut -lGLU -lcglib
+LIBS := -lX11 -lm -lglut -lGLU -lcglib -lpthread
@@ -6,31 +6,55 @@
 CPP_SRCS += \
 ../src/App.cpp \
 ../src/BEVCamera.cpp \
+../src/CollisionBenchmark.cpp \
 ../src/Controller.cpp \
+../src/EntityBenchmark.cpp \
 ../src/Hero.cpp \
 ../src/Particle.cpp \
-../src/ParticleManager.cpp \
+../src/ParticleKernel.cpp \
+../src/ParticlePool.cpp \
+../src/ParticleSystem.cpp \
 ../src/PhysicalEntity.cpp \
+../src/PolygonBenchmark.cpp \
+../src/PropertiesBenchmark.cpp \
+../src/QuaternionBenchmark.cpp \
+../src/VectorBenchmark.cpp \
 ../src/main.cpp 
 
 OBJS += \
 ./src/App.o \
 ./src/BEVCamera.o \
+./src/CollisionBenchmark.o \
 ./src/Controller.o \
+./src/EntityBenchmark.o \
 ./src/Hero.o \
 ./src/Particle.o \
-./src/ParticleManager.o \
+./src/ParticleKernel.o \
+./src/ParticlePool.o \
+./src/ParticleSystem.o \
 ./src/PhysicalEntity.o \
+./src/PolygonBenchmark.o \
+./src/PropertiesBenchmark.o \
+./src/QuaternionBenchmark.o \
+./src/VectorBenchmark.o \
 ./src/main.o 
 
 CPP_DEPS += \
 ./src/App.d \
 ./src/BEVCamera.d \
+./src/CollisionBenchmark.d \
 ./src/Controller.d \
+./src/EntityBenchmark.d \
 ./src/Hero.d \
 ./src/Particle.d \
-./src/ParticleManager.d \
+./src/ParticleKernel.d \
+./src/ParticlePool.d \
+./src/ParticleSystem.d \
 ./src/PhysicalEntity.d \
+./src/PolygonBenchmark.d \
+./src/PropertiesBenchmark.d \
+./src/QuaternionBenchmark.d \
+./src/VectorBenchmark.d \
 ./src/main.d 
 
 
@@ -7,13 +7,60 @@
 
 #include "App.h"
 #include "BEVCamera.h"
+#include "CollisionBenchmark.h"
+#include "EntityBenchmark.h"
 #include "Particle.h"
+#include "PolygonBenchmark.h"
+#include "PropertiesBenchmark.h"
+#include "QuaternionBenchmark.h"
+#include "VectorBenchmark.h"
 #include "Hero.h"
 
 namespace Armageddon {
 
+	typedef struct {
+		const char* property;
+		void (*run)(unsigned int n);
+	} tBenchmark;
+
+	// Each benchmark runs at startup when its property is set above 0, with
+	// its own fixed seed, so that it leaves cg::Random::local() untouched
+	static const tBenchmark BENCHMARKS[] = {
+		{ "ENTITY_BENCHMARK", benchmarkEntityRemoval }, // entities to add and remove
+		{ "COLLISION_BENCHMARK", benchmarkBroadPhase }, // moving boxes
+		{ "POLYGON_BENCHMARK", benchmarkPointInPolygon }, // points to classify
+		{ "VECTOR_BENCHMARK", benchmarkVectors }, // particles to integrate
+		{ "QUATERNION_BENCHMARK", benchmarkQuaternions }, // quaternions
+		{ "PROPERTIES_BENCHMARK", benchmarkPropertiesLoad } // lines of the generated file
+	};
+
+	static void runBenchmarks()
+	{
+		cg::Properties* properties = cg::Properties::instance();
+		for (unsigned int i = 0; i < sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]); i++) {
+			if (properties->exists(BENCHMARKS[i].property) && properties->getInt(BENCHMARKS[i].property) > 0) {
+				BENCHMARKS[i].run(properties->getInt(BENCHMARKS[i].property));
+			}
+		}
+	}
+
 	App::App() : cg::Application("config.ini")
 	{
+		if (cg::Properties::instance()->exists("RANDOM_SEED")) {
+			cg::Random::setSeed(cg::Properties::instance()->getInt("RANDOM_SEED"));
+		}
+		// FIXED_TIMESTEP = milliseconds per update, MAX_SUBSTEPS defaults to 5
+		if (cg::Properties::instance()->exists("FIXED_TIMESTEP")) {
+			if (cg::Properties::instance()->exists("MAX_SUBSTEPS"))
+				setFixedTimeStep(cg::Properties::instance()->getInt("FIXED_TIMESTEP"),
+						 cg::Properties::instance()->getInt("MAX_SUBSTEPS"));
+			else
+				setFixedTimeStep(cg::Properties::instance()->getInt("FIXED_TIMESTEP"));
+		}
+		if (cg::Properties::instance()->exists("THREAD_COUNT")) {
+			cg::ThreadPool::instance()->start(cg::Properties::instance()->getInt("THREAD_COUNT"));
+		}
+		runBenchmarks();
 	}
 
 	App::~App()
@@ -23,9 +70,12 @@ namespace Armageddon {
 	void App::createEntities()
 	{
 		addEntity(new BEVCamera());
-		addEntity(new ParticleManager("ParticleMngr"));
-		addEntity(new Hero("HERO"));
-		addEntity(new Controller());
+		// Large numbers of simple objects live in the component store
+		cg::ComponentStore* world = new cg::ComponentStore("World");
+		world->addSystem(new ParticleSystem("Particles"));
+		addEntity(world);
+		cg::EntityHandle hero = addEntity(new Hero("HERO"));
+		addEntity(new Controller(hero));
 	}
 
 }
@@ -10,7 +10,7 @@
 
 #include "cg/cg.h"
 
-#include "ParticleManager.h"
+#include "ParticleSystem.h"
 #include "Controller.h"
 
 namespace Armageddon {
@@ -0,0 +1,91 @@
+/*
+ * CollisionBenchmark.cpp
+ */
+
+#include "CollisionBenchmark.h"
+#include <sstream>
+#include <vector>
+
+namespace Armageddon {
+
+	static const float BOX_SIZE = 4.0f;
+	static const double CELL_SIZE = 16.0;
+	static const unsigned int FRAMES = 100;
+	static const uint32_t SEED = 11; // the same boxes on every run
+
+	void benchmarkBroadPhase(unsigned int n)
+	{
+		// The area of the default application window
+		cg::tWindow window;
+		window.x = window.y = 0;
+		window.width = 640;
+		window.height = 480;
+		window.display_mode = 0;
+		float width = window.width, height = window.height;
+		std::vector<float> x(n), y(n), vx(n), vy(n);
+		cg::Random random(SEED);
+		random.fill(&x[0], n, 0, width - BOX_SIZE);
+		random.fill(&y[0], n, 0, height - BOX_SIZE);
+		random.fill(&vx[0], n, -1, 1);
+		random.fill(&vy[0], n, -1, 1);
+
+		cg::SpatialGrid grid;
+		grid.setup(window, CELL_SIZE);
+		std::vector<cg::tCollisionPair> pairs;
+		unsigned long total = 0;
+		uint64_t start = cg::Clock::nanoseconds();
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			for (unsigned int i = 0; i < n; i++) {
+				x[i] += vx[i];
+				y[i] += vy[i];
+				if (x[i] < 0 || x[i] > width - BOX_SIZE)
+					vx[i] = -vx[i];
+				if (y[i] < 0 || y[i] > height - BOX_SIZE)
+					vy[i] = -vy[i];
+				grid.update(i, cg::Vector2d(x[i], y[i]), cg::Vector2d(x[i] + BOX_SIZE, y[i] + BOX_SIZE));
+			}
+			grid.findPairs(pairs);
+			total += pairs.size();
+		}
+		uint64_t elapsed = cg::Clock::nanoseconds() - start;
+
+		// Brute force reference on the last frame
+		start = cg::Clock::nanoseconds();
+		unsigned long naive = 0;
+		for (unsigned int i = 0; i < n; i++) {
+			for (unsigned int j = i + 1; j < n; j++) {
+				if (x[i] <= x[j] + BOX_SIZE && x[j] <= x[i] + BOX_SIZE
+						&& y[i] <= y[j] + BOX_SIZE && y[j] <= y[i] + BOX_SIZE)
+					naive++;
+			}
+		}
+		uint64_t naiveElapsed = cg::Clock::nanoseconds() - start;
+
+		// Same search with the batch AABB test: every box against all boxes,
+		// counting each pair twice plus one self hit per box
+		std::vector<float> maxX(n), maxY(n);
+		for (unsigned int i = 0; i < n; i++) {
+			maxX[i] = x[i] + BOX_SIZE;
+			maxY[i] = y[i] + BOX_SIZE;
+		}
+		std::vector<uint32_t> hits((n + 31) / 32);
+		cg::Util* util = cg::Util::instance();
+		start = cg::Clock::nanoseconds();
+		unsigned long batch = 0;
+		for (unsigned int i = 0; i < n; i++)
+			batch += util->isAABBoxCollision(x[i], y[i], maxX[i], maxY[i], &x[0], &y[0], &maxX[0], &maxY[0], n, &hits[0]);
+		batch = (batch - n) / 2;
+		uint64_t batchElapsed = cg::Clock::nanoseconds() - start;
+
+		std::ostringstream os;
+		os << "[CollisionBenchmark] " << n << " boxes: grid " << elapsed * 1e-6 / FRAMES
+		   << " ms/frame (" << total / FRAMES << " pairs/frame), brute force "
+		   << naiveElapsed * 1e-6 << " ms (" << naive << " pairs)";
+		cg::DebugFile::instance()->writeLine(os.str());
+		os.str("");
+		os << "[CollisionBenchmark] " << n << " boxes: batch AABB " << batchElapsed * 1e-6
+		   << " ms (" << batch << " pairs)";
+		cg::DebugFile::instance()->writeLine(os.str());
+	}
+
+}
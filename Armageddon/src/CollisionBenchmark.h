@@ -0,0 +1,24 @@
+/*
+ * CollisionBenchmark.h
+ */
+
+#ifndef COLLISIONBENCHMARK_H_
+#define COLLISIONBENCHMARK_H_
+
+#include "cg/cg.h"
+
+namespace Armageddon {
+
+	/** Moves n small boxes around a 640x480 window for 100 frames,
+	 *  finding the colliding pairs each frame with a cg::SpatialGrid, and
+	 *  logs the average time per frame to the debug file, along with the
+	 *  time of a brute force O(n^2) search on the last frame, both with the
+	 *  scalar test and with the batch cg::Util::isAABBoxCollision. The
+	 *  grid and the batch test are checked against brute force by the
+	 *  cglib.test project.
+	 */
+	void benchmarkBroadPhase(unsigned int n);
+
+}
+
+#endif /* COLLISIONBENCHMARK_H_ */
@@ -11,7 +11,7 @@
 
 namespace Armageddon {
 
-	Controller::Controller() : cg::Entity("Controller")
+	Controller::Controller(cg::EntityHandle hero) : cg::Entity("Controller"), _heroHandle(hero)
 	{
 	}
 
@@ -21,10 +21,15 @@ namespace Armageddon {
 
 	void Controller::init()
 	{
-		_hero = (Hero*) cg::Registry::instance()->get("HERO");
 		_dirKeys = cg::Vector2d(0.0, 0.0);
 	}
 
+	// Null once the hero has been removed from the registry
+	Hero* Controller::getHero()
+	{
+		return (Hero*) cg::Registry::instance()->get(_heroHandle);
+	}
+
 	void Controller::onKeyPressed(unsigned char key)
 	{
 		if (key == 27) {
@@ -39,7 +44,10 @@ namespace Armageddon {
 
 	void Controller::onSpecialKeyPressed(int key)
 	{
-		cg::Vector2d keys = _hero->getArrowKeyPressed();
+		Hero* hero = getHero();
+		if (hero == 0)
+			return;
+		cg::Vector2d keys = hero->getArrowKeyPressed();
 		switch (key) {
 		case GLUT_KEY_UP:
 			_dirKeys[1]=1;
@@ -58,13 +66,16 @@ namespace Armageddon {
 			keys[0] += 1;
  			break;
 		}
-		_hero->applyForce(_dirKeys);
-		_hero->setArrowKeyPressed(keys);
+		hero->applyForce(_dirKeys);
+		hero->setArrowKeyPressed(keys);
 
 	}
 
 	void Controller::onSpecialKeyReleased(int key)
 	{
+		Hero* hero = getHero();
+		if (hero == 0)
+			return;
 		int left=1;
 		int up=2;
 		int right=3;
@@ -72,19 +83,19 @@ namespace Armageddon {
 		switch (key) {
 		case GLUT_KEY_UP:
 			_dirKeys[1]=0;
-			_hero->keyBreak(up);
+			hero->keyBreak(up);
 			break;
 		case GLUT_KEY_DOWN:
 			_dirKeys[1]=0;
-			_hero->keyBreak(down);
+			hero->keyBreak(down);
 			break;
 		case GLUT_KEY_LEFT:
 			_dirKeys[0]=0;
-			_hero->keyBreak(left);
+			hero->keyBreak(left);
 			break;
 		case GLUT_KEY_RIGHT:
 			_dirKeys[0]=0;
-			_hero->keyBreak(right);
+			hero->keyBreak(right);
 			break;
 		}
 	}
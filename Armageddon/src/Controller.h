@@ -18,13 +18,13 @@ namespace Armageddon {
 			   public cg::IKeyboardEventListener {
 
 	private:
-		Hero* _hero;
+		cg::EntityHandle _heroHandle;
 		cg::Vector2d _dirKeys;
 
-
+		Hero* getHero();
 
 	public:
-		Controller();
+		Controller(cg::EntityHandle hero);
 		virtual ~Controller();
 		void init();
 		void onKeyPressed(unsigned char key);
@@ -0,0 +1,60 @@
+/*
+ * EntityBenchmark.cpp
+ */
+
+#include "EntityBenchmark.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include "cg/cg.h"
+
+namespace Armageddon {
+
+	class BenchmarkEntity : public cg::Entity, public cg::IUpdateListener {
+	public:
+		BenchmarkEntity(const std::string& id) : cg::Entity(id) {}
+		void init() {}
+		void update(unsigned long elapsed_millis) {}
+	};
+
+	static void logRemoval(const std::string& name, unsigned int n, uint64_t nanos)
+	{
+		std::ostringstream os;
+		os << "[EntityBenchmark] " << name << ": " << n << " removals in " << nanos * 1e-6 << " ms";
+		cg::DebugFile::instance()->writeLine(os.str());
+	}
+
+	static void benchmarkMap(const std::vector<std::string>& ids, bool preserve_order, bool deferred)
+	{
+		cg::LockableOrderedMap<cg::Entity> map;
+		map.setPreserveOrder(preserve_order);
+		for (unsigned int i = 0; i < ids.size(); i++)
+			map.add(ids[i], new BenchmarkEntity(ids[i]));
+		uint64_t start = cg::Clock::nanoseconds();
+		if (deferred)
+			map.lock();
+		for (unsigned int i = 0; i < ids.size(); i++)
+			map.destroy(ids[i]);
+		if (deferred)
+			map.unlock();
+		map.begin();
+		uint64_t elapsed = cg::Clock::nanoseconds() - start;
+		logRemoval(std::string("LockableOrderedMap ") + (preserve_order ? "ordered" : "swap")
+			   + (deferred ? " deferred" : " immediate"), (unsigned int)ids.size(), elapsed);
+	}
+
+	void benchmarkEntityRemoval(unsigned int n)
+	{
+		std::vector<std::string> ids(n);
+		for (unsigned int i = 0; i < n; i++) {
+			std::ostringstream os;
+			os << "Benchmark" << i;
+			ids[i] = os.str();
+		}
+		benchmarkMap(ids, true, false);
+		benchmarkMap(ids, true, true);
+		benchmarkMap(ids, false, false);
+		benchmarkMap(ids, false, true);
+	}
+
+}
@@ -0,0 +1,20 @@
+/*
+ * EntityBenchmark.h
+ */
+
+#ifndef ENTITYBENCHMARK_H_
+#define ENTITYBENCHMARK_H_
+
+namespace Armageddon {
+
+	/** Adds n entities and removes them all, one by one in insertion order,
+	 *  from a local cg::LockableOrderedMap (order preserving and swap
+	 *  removal, unlocked and deferred until unlock), and logs the time taken
+	 *  by each case to the debug file. The cg::Registry and the notifiers
+	 *  of the application are left untouched.
+	 */
+	void benchmarkEntityRemoval(unsigned int n);
+
+}
+
+#endif /* ENTITYBENCHMARK_H_ */
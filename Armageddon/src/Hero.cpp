@@ -24,8 +24,9 @@ namespace Armageddon {
 	void Hero::init()
 	{
 		_size = cg::Properties::instance()->getVector2d("BAT_SIZE");
-		_maxSpeed = cg::Properties::instance()->getDouble("HERO_MAX_SPEED");
-		_movForce = cg::Properties::instance()->getDouble("HERO_MOV_FORCE");
+		// handles, so that a reloaded properties file takes effect on the next update
+		_maxSpeed.bind("HERO_MAX_SPEED");
+		_movForce.bind("HERO_MOV_FORCE");
 		_winHeight = cg::Manager::instance()->getApp()->getWindow().height;
 		_velocity = cg::Vector2d(0.0, 0.0);
 		_appForce = cg::Vector2d(0.0,0.0);
@@ -33,13 +34,20 @@ namespace Armageddon {
 		_atrittionFactor = 100;
 		_mass = 500;
 		_arrowKeyPressed =cg::Vector2d(0.0, 0.0);
+		_velocityGauges[0] = cg::Metrics::instance()->getGauge("hero.velocity.x");
+		_velocityGauges[1] = cg::Metrics::instance()->getGauge("hero.velocity.y");
+		_forceGauges[0] = cg::Metrics::instance()->getGauge("hero.force.x");
+		_forceGauges[1] = cg::Metrics::instance()->getGauge("hero.force.y");
 	}
 
 	void Hero::draw()
 	{
-
-		cg::Vector2d min = _position - _size/2.0;
-		cg::Vector2d max = _position + _size/2.0;
+		// Interpolates between the last two simulated positions (alpha is 1
+		// unless the application runs with a fixed time step)
+		double alpha = cg::Manager::instance()->getApp()->getTime().alpha;
+		cg::Vector2d position = _previousPosition * (1.0 - alpha) + _position * alpha;
+		cg::Vector2d min = position - _size/2.0;
+		cg::Vector2d max = position + _size/2.0;
 		glColor3d(0.9, 0.9, 0.9);
 		glLineWidth(1.5);
 		glLineWidth(1.5);
@@ -56,15 +64,18 @@ namespace Armageddon {
 
 
 		double time = (double) elapsed_millis;
-		if (_velocity[0] < -_maxSpeed)
-			_velocity[0] = -_maxSpeed;
-		else if (_velocity[0] > _maxSpeed)
-			_velocity[0] = _maxSpeed;
-
-		if (_velocity[1] < -_maxSpeed)
-			_velocity[1] = -_maxSpeed;
-		else if (_velocity[1] > _maxSpeed)
-			_velocity[1] = _maxSpeed;
+		double max_speed = _maxSpeed.get();
+		double mov_force = _movForce.get();
+		_previousPosition = _position;
+		if (_velocity[0] < -max_speed)
+			_velocity[0] = -max_speed;
+		else if (_velocity[0] > max_speed)
+			_velocity[0] = max_speed;
+
+		if (_velocity[1] < -max_speed)
+			_velocity[1] = -max_speed;
+		else if (_velocity[1] > max_speed)
+			_velocity[1] = max_speed;
 
 /*		if ( _appForce[0] && _appForce[1]) {
 			_appForce[0] = _appForce[0] / sqrt(2.0);
@@ -72,7 +83,10 @@ namespace Armageddon {
 		}
 
 */
-		printf("%f - %f \n", fabs(_velocity[0]), _velocity[1]);
+		_velocityGauges[0]->set(_velocity[0]);
+		_velocityGauges[1]->set(_velocity[1]);
+		_forceGauges[0]->set(_appForce[0]);
+		_forceGauges[1]->set(_appForce[1]);
 
 		_acceleration[0] = _appForce[0]/_mass;
 		_acceleration[1] = _appForce[1]/_mass;
@@ -100,16 +114,16 @@ namespace Armageddon {
 		/* HACK: If the ship is breaking and another key is pressed, this will prevent it from
 		 * sailing away on its own */
 		else if (_appForce[0] >= 0 && _velocity[0]>0 && _arrowKeyPressed[0] == 0)
-			_appForce[0] = -_movForce;
+			_appForce[0] = -mov_force;
 
 		else if (_appForce[0] <= 0 && _velocity[0] < 0 && _arrowKeyPressed[0] == 0)
-			_appForce[0] = _movForce;
+			_appForce[0] = mov_force;
 
 		else if (_appForce[1] >= 0 && _velocity[1] > 0 && _arrowKeyPressed[1] == 0)
-			_appForce[1] = -_movForce;
+			_appForce[1] = -mov_force;
 
 		else if (_appForce[1] <= 0 && _velocity[1] < 0 && _arrowKeyPressed[1] == 0)
-			_appForce[1] = _movForce;
+			_appForce[1] = mov_force;
 		/**************************************************************************/
 
 		if (_appForce[1] > 0 && _velocity[1]<0) {
@@ -143,19 +157,19 @@ namespace Armageddon {
 
 		switch (direction) {
 		case 1: //LEFT
-			_appForce[0] = _movForce;
+			_appForce[0] = _movForce.get();
 			_arrowKeyPressed[0] += 1;
 			break;
 		case 2: //UP
-			_appForce[1] = -_movForce;
+			_appForce[1] = -_movForce.get();
 			_arrowKeyPressed[1] -= 1;
 			break;
 		case 3: //RIGHT
-			_appForce[0] = -_movForce;
+			_appForce[0] = -_movForce.get();
 			_arrowKeyPressed[0] -= 1;
 			break;
 		case 4: //DOWN
-			_appForce[1] = _movForce;
+			_appForce[1] = _movForce.get();
 			_arrowKeyPressed[1] += 1;
 			break;
 
@@ -183,5 +197,6 @@ namespace Armageddon {
 	{
 		_position[0] = x;
 		_position[1] = _winHeight -y;
+		_previousPosition = _position;
 	}
 }
@@ -23,15 +23,18 @@ namespace Armageddon {
 	private:
 		double _winHeight;
 		cg::Vector2d _position;
+		cg::Vector2d _previousPosition;
 		cg::Vector2d _velocity;
 		cg::Vector2d _size;
 		cg::Vector2d _appForce;
 		cg::Vector2d _acceleration;
 		double _atrittionFactor;
 		double _mass;
-		double _maxSpeed;
-		double _movForce;
+		cg::PropertyHandle<double> _maxSpeed;
+		cg::PropertyHandle<double> _movForce;
 		cg::Vector2d _arrowKeyPressed;
+		cg::Gauge* _velocityGauges[2];
+		cg::Gauge* _forceGauges[2];
 
 	public:
 		Hero(std::string id);
@@ -8,28 +8,27 @@
 #ifndef PARTICLE_H_
 #define PARTICLE_H_
 #include "cg/cg.h"
+#include "ParticlePool.h"
 namespace Armageddon {
 
-	class Particle : public cg::Entity,
-			 public cg::IDrawListener,
-			 public cg::IUpdateListener
+	/** Particle is a lightweight view over one slot of a ParticlePool.
+	 *  It owns no state, so it can be created on the stack whenever a
+	 *  single particle needs to be inspected or modified.
+	 */
+	class Particle
 	{
 
 	private:
-		cg::Vector3d _position, _size;
-		cg::Vector3d _color;
-		cg::Vector3d _velocity;
-		double _winWidth, _winHeight;
-
-		double randomBetween(double min, double max);
+		ParticlePool* _pool;
+		unsigned int _index;
 
 	public:
-		Particle(std::string id);
+		Particle(ParticlePool* pool, unsigned int index);
 		~Particle();
-		void init();
 		void draw();
-		void reset(cg::Vector3d position);
-		void update(unsigned long elapsed_millis);
+		void reset(cg::Random& random, double win_width, double win_height);
+		cg::Vector3d getPosition() const;
+		cg::Vector3d getVelocity() const;
 
 	};
 
@@ -0,0 +1,174 @@
+/*
+ * ParticleKernel.cpp
+ */
+
+#include <sstream>
+#include "cg/cg.h"
+#include "ParticleKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PARTICLE_KERNEL_X86
+#endif
+
+namespace Armageddon {
+
+	static void integrateScalar(ParticlePool& pool, unsigned int begin, unsigned int end,
+			float elapsed_seconds, float width, float height, uint32_t* outside)
+	{
+		float* px = &pool.positionX[0];
+		float* py = &pool.positionY[0];
+		const float* vx = &pool.velocityX[0];
+		const float* vy = &pool.velocityY[0];
+		for (unsigned int w = begin / 32; w < (end + 31) / 32; w++) {
+			outside[w] = 0;
+		}
+		for (unsigned int i = begin; i < end; i++) {
+			float x = px[i] - vx[i] * elapsed_seconds;
+			float y = py[i] - vy[i] * elapsed_seconds;
+			px[i] = x;
+			py[i] = y;
+			if (x < 0 || x > width || y < 0 || y > height) {
+				outside[i / 32] |= 1u << (i % 32);
+			}
+		}
+	}
+
+#ifdef PARTICLE_KERNEL_X86
+
+	__attribute__((target("sse2")))
+	static void integrateSSE2(ParticlePool& pool, unsigned int begin, unsigned int end,
+			float elapsed_seconds, float width, float height, uint32_t* outside)
+	{
+		float* px = &pool.positionX[0];
+		float* py = &pool.positionY[0];
+		const float* vx = &pool.velocityX[0];
+		const float* vy = &pool.velocityY[0];
+		const __m128 dt = _mm_set1_ps(elapsed_seconds);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 w = _mm_set1_ps(width);
+		const __m128 h = _mm_set1_ps(height);
+		unsigned int i = begin;
+		for (; i + 32 <= end; i += 32) {
+			uint32_t mask = 0;
+			for (unsigned int j = 0; j < 32; j += 4) {
+				__m128 x = _mm_sub_ps(_mm_loadu_ps(px + i + j), _mm_mul_ps(_mm_loadu_ps(vx + i + j), dt));
+				__m128 y = _mm_sub_ps(_mm_loadu_ps(py + i + j), _mm_mul_ps(_mm_loadu_ps(vy + i + j), dt));
+				_mm_storeu_ps(px + i + j, x);
+				_mm_storeu_ps(py + i + j, y);
+				__m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpgt_ps(x, w)),
+						       _mm_or_ps(_mm_cmplt_ps(y, zero), _mm_cmpgt_ps(y, h)));
+				mask |= (uint32_t)_mm_movemask_ps(out) << j;
+			}
+			outside[i / 32] = mask;
+		}
+		if (i < end) {
+			integrateScalar(pool, i, end, elapsed_seconds, width, height, outside);
+		}
+	}
+
+	__attribute__((target("avx2")))
+	static void integrateAVX2(ParticlePool& pool, unsigned int begin, unsigned int end,
+			float elapsed_seconds, float width, float height, uint32_t* outside)
+	{
+		float* px = &pool.positionX[0];
+		float* py = &pool.positionY[0];
+		const float* vx = &pool.velocityX[0];
+		const float* vy = &pool.velocityY[0];
+		const __m256 dt = _mm256_set1_ps(elapsed_seconds);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 w = _mm256_set1_ps(width);
+		const __m256 h = _mm256_set1_ps(height);
+		unsigned int i = begin;
+		for (; i + 32 <= end; i += 32) {
+			uint32_t mask = 0;
+			for (unsigned int j = 0; j < 32; j += 8) {
+				__m256 x = _mm256_sub_ps(_mm256_loadu_ps(px + i + j), _mm256_mul_ps(_mm256_loadu_ps(vx + i + j), dt));
+				__m256 y = _mm256_sub_ps(_mm256_loadu_ps(py + i + j), _mm256_mul_ps(_mm256_loadu_ps(vy + i + j), dt));
+				_mm256_storeu_ps(px + i + j, x);
+				_mm256_storeu_ps(py + i + j, y);
+				__m256 out = _mm256_or_ps(
+						_mm256_or_ps(_mm256_cmp_ps(x, zero, _CMP_LT_OQ), _mm256_cmp_ps(x, w, _CMP_GT_OQ)),
+						_mm256_or_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), _mm256_cmp_ps(y, h, _CMP_GT_OQ)));
+				mask |= (uint32_t)_mm256_movemask_ps(out) << j;
+			}
+			outside[i / 32] = mask;
+		}
+		if (i < end) {
+			integrateScalar(pool, i, end, elapsed_seconds, width, height, outside);
+		}
+	}
+
+#endif
+
+	static const tParticleKernel KERNELS[] = {
+		{ "scalar", integrateScalar },
+#ifdef PARTICLE_KERNEL_X86
+		{ "sse2", integrateSSE2 },
+		{ "avx2", integrateAVX2 },
+#endif
+	};
+	static const unsigned int NKERNELS = sizeof(KERNELS) / sizeof(KERNELS[0]);
+
+	static bool isSupported(const tParticleKernel& kernel)
+	{
+#ifdef PARTICLE_KERNEL_X86
+		__builtin_cpu_init();
+		if (kernel.integrate == integrateSSE2)
+			return __builtin_cpu_supports("sse2");
+		if (kernel.integrate == integrateAVX2)
+			return __builtin_cpu_supports("avx2");
+#endif
+		return true;
+	}
+
+	std::vector<tParticleKernel> supportedParticleKernels()
+	{
+		std::vector<tParticleKernel> kernels;
+		for (unsigned int k = 0; k < NKERNELS; k++) {
+			if (isSupported(KERNELS[k]))
+				kernels.push_back(KERNELS[k]);
+		}
+		return kernels;
+	}
+
+	const tParticleKernel& selectParticleKernel(const std::string& name)
+	{
+		const tParticleKernel* best = &KERNELS[0];
+		for (unsigned int k = 0; k < NKERNELS; k++) {
+			if (!isSupported(KERNELS[k]))
+				continue;
+			if (name == KERNELS[k].name)
+				return KERNELS[k];
+			best = &KERNELS[k];
+		}
+		return *best;
+	}
+
+	void benchmarkParticleKernels(const ParticlePool& pool, float width, float height, unsigned long millis)
+	{
+		unsigned int n = pool.size();
+		if (n == 0)
+			return;
+		std::vector<uint32_t> outside((n + 31) / 32);
+		std::vector<tParticleKernel> kernels = supportedParticleKernels();
+		for (unsigned int k = 0; k < kernels.size(); k++) {
+			ParticlePool copy = pool;
+			unsigned long iterations = 0;
+			unsigned long start = cg::Util::instance()->getSystemTime();
+			unsigned long elapsed = 0;
+			while (elapsed < millis) {
+				// alternate directions so that particles stay in range
+				float dt = (iterations % 2) ? -0.001f : 0.001f;
+				kernels[k].integrate(copy, 0, n, dt, width, height, &outside[0]);
+				iterations++;
+				elapsed = cg::Util::instance()->getSystemTime() - start;
+			}
+			std::ostringstream os;
+			os << "[ParticleKernel] " << kernels[k].name << ": "
+			   << (double)n * iterations / (elapsed / 1000.0) << " particles/s";
+			cg::DebugFile::instance()->writeLine(os.str());
+		}
+	}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * ParticleKernel.h
+ */
+
+#ifndef PARTICLEKERNEL_H_
+#define PARTICLEKERNEL_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ParticlePool.h"
+
+namespace Armageddon {
+
+	/** Integrates the particles [begin, end) of a pool over elapsed_seconds and
+	 *  sets, in the bitmask outside (one bit per particle, 32 per word), the
+	 *  bit of every particle that left the [0,width]x[0,height] window.
+	 *  begin must be a multiple of 32, so that each call owns its mask words.
+	 */
+	typedef void (*tIntegrateFunction)(ParticlePool& pool, unsigned int begin, unsigned int end,
+			float elapsed_seconds, float width, float height, uint32_t* outside);
+
+	typedef struct {
+		const char* name;
+		tIntegrateFunction integrate;
+	} tParticleKernel;
+
+	/** Returns the kernel with the given name ("scalar", "sse2" or "avx2") if the
+	 *  CPU supports it, otherwise the fastest kernel the CPU supports.
+	 */
+	const tParticleKernel& selectParticleKernel(const std::string& name);
+
+	/** Returns every kernel the CPU supports, slowest first. */
+	std::vector<tParticleKernel> supportedParticleKernels();
+
+	/** Runs every supported kernel over a copy of pool for at least
+	 *  millis milliseconds each and logs particles/second to the debug file.
+	 */
+	void benchmarkParticleKernels(const ParticlePool& pool, float width, float height, unsigned long millis);
+
+}
+
+#endif /* PARTICLEKERNEL_H_ */
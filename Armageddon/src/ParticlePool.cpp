@@ -0,0 +1,36 @@
+/*
+ * ParticlePool.cpp
+ */
+
+#include "ParticlePool.h"
+
+namespace Armageddon {
+
+	ParticlePool::ParticlePool()
+	{
+	}
+
+	ParticlePool::~ParticlePool()
+	{
+	}
+
+	void ParticlePool::resize(unsigned int n)
+	{
+		positionX.resize(n);
+		positionY.resize(n);
+		positionZ.resize(n);
+		velocityX.resize(n);
+		velocityY.resize(n);
+		sizeX.resize(n);
+		sizeY.resize(n);
+		colorR.resize(n);
+		colorG.resize(n);
+		colorB.resize(n);
+	}
+
+	unsigned int ParticlePool::size() const
+	{
+		return (unsigned int)positionX.size();
+	}
+
+}
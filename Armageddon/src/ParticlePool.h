@@ -0,0 +1,32 @@
+/*
+ * ParticlePool.h
+ */
+
+#ifndef PARTICLEPOOL_H_
+#define PARTICLEPOOL_H_
+
+#include <vector>
+
+namespace Armageddon {
+
+	/** ParticlePool keeps the state of all particles as a structure of arrays:
+	 *  each component lives in its own contiguous array, indexed by particle,
+	 *  so that the update and draw loops stream linearly through memory.
+	 */
+	class ParticlePool {
+
+	public:
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> velocityX, velocityY;
+		std::vector<float> sizeX, sizeY;
+		std::vector<float> colorR, colorG, colorB;
+
+		ParticlePool();
+		~ParticlePool();
+		void resize(unsigned int n);
+		unsigned int size() const;
+	};
+
+}
+
+#endif /* PARTICLEPOOL_H_ */
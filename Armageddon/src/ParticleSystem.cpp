@@ -0,0 +1,196 @@
+/*
+ * ParticleSystem.cpp
+ */
+
+#include "ParticleSystem.h"
+#include <sstream>
+
+namespace Armageddon
+	{
+
+	// Particles integrated per cg::ThreadPool chunk, a multiple of 32 so
+	// that chunks never share a word of the outside bitmask
+	static const unsigned int UPDATE_GRAIN = 4096;
+
+	ParticleSystem::ParticleSystem(std::string name) : cg::ComponentSystem(name), _pool(0), _isResizePending(false)
+	{
+	}
+
+	ParticleSystem::~ParticleSystem()
+	{
+		cg::Properties::instance()->unsubscribe(this);
+	}
+
+	// Creates a single emitter holding NPARTICLE particles
+	void ParticleSystem::init(cg::ComponentStore& store)
+	{
+		// Parsed once for the whole pool; NPARTICLE can be changed live
+		_nParticle.bind("NPARTICLE");
+		_minSize.bind("MIN_SIZE");
+		_maxSize.bind("MAX_SIZE");
+		cg::Properties::instance()->subscribe("NPARTICLE", this);
+		cg::tWindow win = cg::Manager::instance()->getApp()->getWindow();
+		_winWidth = win.width;
+		_winHeight = win.height;
+		// PARTICLE_RENDERER = batch | immediate
+		_batchDraw = cg::Properties::instance()->exists("PARTICLE_RENDERER")
+			&& cg::Properties::instance()->getString("PARTICLE_RENDERER") == "batch";
+		// PARTICLE_KERNEL = scalar | sse2 | avx2, anything else picks the fastest supported
+		std::string kernel = "";
+		if (cg::Properties::instance()->exists("PARTICLE_KERNEL"))
+			kernel = cg::Properties::instance()->getString("PARTICLE_KERNEL");
+		_kernel = selectParticleKernel(kernel);
+		cg::DebugFile::instance()->writeLine(std::string("[ParticleSystem] kernel ") + _kernel.name);
+		if (_nParticle.get() <= 0)
+			return;
+		resize(store, _nParticle.get());
+		ParticlePool& pool = store.getComponents<ParticlePool>().at(0);
+		if (cg::Properties::instance()->exists("PARTICLE_KERNEL_BENCHMARK")
+				&& cg::Properties::instance()->getInt("PARTICLE_KERNEL_BENCHMARK")) {
+			benchmarkParticleKernels(pool, _winWidth, _winHeight, 500);
+		}
+	}
+
+	// Creates particles [begin, end) of the pool, one component array at a time
+	void ParticleSystem::spawn(ParticlePool& pool, unsigned int begin, unsigned int end)
+	{
+		unsigned int n = end - begin;
+		double min_size = _minSize.get();
+		double max_size = _maxSize.get();
+		cg::Random& random = cg::Random::local();
+		random.fill(&pool.positionX[begin], n, 0, _winWidth);
+		random.fill(&pool.positionY[begin], n, 0, _winHeight);
+		random.fill(&pool.positionZ[begin], n, 300, 399);
+		random.fill(&pool.sizeX[begin], n, min_size, max_size);
+		random.fill(&pool.sizeY[begin], n, min_size, max_size);
+		random.fill(&pool.velocityX[begin], n, -10, 10);
+		random.fill(&pool.velocityY[begin], n, 30, 60);
+		std::fill(pool.colorR.begin() + begin, pool.colorR.end(), 1.0f);
+		std::fill(pool.colorG.begin() + begin, pool.colorG.end(), 1.0f);
+		std::fill(pool.colorB.begin() + begin, pool.colorB.end(), 1.0f);
+	}
+
+	// Grows or shrinks the first emitter to n particles, creating it if needed
+	void ParticleSystem::resize(cg::ComponentStore& store, unsigned int n)
+	{
+		if (store.getComponents<ParticlePool>().size() == 0) {
+			if (n == 0)
+				return;
+			store.addComponent(store.create(), ParticlePool());
+		}
+		ParticlePool& pool = store.getComponents<ParticlePool>().at(0);
+		unsigned int old_size = pool.size();
+		pool.resize(n);
+		if (n > old_size)
+			spawn(pool, old_size, n);
+	}
+
+	void ParticleSystem::onPropertyChanged(const std::string& name)
+	{
+		// Applied by the next update, which has the store at hand
+		_isResizePending = true;
+	}
+
+	void ParticleSystem::update(cg::ComponentStore& store, unsigned long elapsed_millis)
+	{
+		if (_isResizePending) {
+			_isResizePending = false;
+			unsigned int n = _nParticle.get() > 0 ? _nParticle.get() : 0;
+			cg::ComponentArray<ParticlePool>& pools = store.getComponents<ParticlePool>();
+			if (n != (pools.size() > 0 ? pools.at(0).size() : 0)) {
+				resize(store, n);
+				std::ostringstream os;
+				os << "[ParticleSystem] resized to " << n << " particles";
+				cg::DebugFile::instance()->writeLine(os.str());
+			}
+		}
+		_elapsedSeconds = elapsed_millis / 1000.0f;
+		cg::ComponentArray<ParticlePool>& pools = store.getComponents<ParticlePool>();
+		for (unsigned int p = 0; p < pools.size(); p++) {
+			_pool = &pools.at(p);
+			unsigned int n = _pool->size();
+			if (n == 0)
+				continue;
+			_outside.resize((n + 31) / 32);
+			cg::ThreadPool::instance()->run(this, n, UPDATE_GRAIN);
+			// Respawn serially and in index order from this thread's stream, so
+			// the numbers drawn do not depend on the number of threads.
+			cg::Random& random = cg::Random::local();
+			for (unsigned int w = 0; w < _outside.size(); w++) {
+				uint32_t mask = _outside[w];
+				while (mask) {
+					unsigned int bit = __builtin_ctz(mask);
+					mask &= mask - 1;
+					Particle(_pool, w * 32 + bit).reset(random, _winWidth, _winHeight);
+				}
+			}
+		}
+		_pool = 0;
+	}
+
+	void ParticleSystem::run(unsigned int begin, unsigned int end)
+	{
+		_kernel.integrate(*_pool, begin, end, _elapsedSeconds, _winWidth, _winHeight, &_outside[0]);
+	}
+
+	void ParticleSystem::draw(cg::ComponentStore& store)
+	{
+		cg::ComponentArray<ParticlePool>& pools = store.getComponents<ParticlePool>();
+		for (unsigned int p = 0; p < pools.size(); p++) {
+			if (_batchDraw)
+				drawBatch(pools.at(p));
+			else
+				drawImmediate(pools.at(p));
+		}
+	}
+
+	void ParticleSystem::drawImmediate(ParticlePool& pool)
+	{
+		unsigned int n = pool.size();
+		for (unsigned int i = 0; i < n; i++) {
+			Particle(&pool, i).draw();
+		}
+	}
+
+	// Builds one interleaved (r,g,b,x,y,z) quad list for the whole pool and
+	// submits it with a single glDrawArrays call.
+	void ParticleSystem::drawBatch(ParticlePool& pool)
+	{
+		const unsigned int stride = 6;
+		unsigned int n = pool.size();
+		if (n == 0)
+			return;
+		_vertices.resize(n * 4 * stride);
+		float* v = &_vertices[0];
+		for (unsigned int i = 0; i < n; i++) {
+			float x = pool.positionX[i];
+			float y = pool.positionY[i];
+			float dx = pool.sizeX[i] / 100.0f;
+			float dy = pool.sizeY[i] / 100.0f;
+			float r = pool.colorR[i];
+			float g = pool.colorG[i];
+			float b = pool.colorB[i];
+			float corners[4][2] = { {x - dx, y - dy}, {x + dx, y - dy},
+						{x + dx, y + dy}, {x - dx, y + dy} };
+			for (int c = 0; c < 4; c++) {
+				v[0] = r; v[1] = g; v[2] = b;
+				v[3] = corners[c][0]; v[4] = corners[c][1]; v[5] = -400;
+				v += stride;
+			}
+		}
+		glEnableClientState(GL_COLOR_ARRAY);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glColorPointer(3, GL_FLOAT, stride * sizeof(float), &_vertices[0]);
+		glVertexPointer(3, GL_FLOAT, stride * sizeof(float), &_vertices[3]);
+		glDrawArrays(GL_QUADS, 0, n * 4);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisableClientState(GL_COLOR_ARRAY);
+	}
+
+	void ParticleSystem::drawOverlay(cg::ComponentStore& store)
+	{
+		glColor3d(0.9, 0.1, 0.1);
+		cg::Util::instance()->drawBitmapString(nparticleMessage,10,10);
+	}
+}
+
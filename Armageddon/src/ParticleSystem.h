@@ -0,0 +1,54 @@
+/*
+ * ParticleSystem.h
+ */
+
+#ifndef PARTICLESYSTEM_H_
+#define PARTICLESYSTEM_H_
+#include "Particle.h"
+#include "ParticleKernel.h"
+#include "ParticlePool.h"
+
+namespace Armageddon {
+
+	/** ParticleSystem simulates and draws the particles of a cg::ComponentStore.
+	 *  Particles are grouped in emitters: each emitter is an entity of the
+	 *  store with a ParticlePool component, so that every pool keeps the
+	 *  structure of arrays layout the integration kernels need.
+	 */
+	class ParticleSystem : public cg::ComponentSystem,
+				public cg::IParallelTask,
+				public cg::IPropertyListener {
+
+	private:
+		ParticlePool* _pool;
+		double _winWidth, _winHeight;
+		float _elapsedSeconds;
+		tParticleKernel _kernel;
+		std::vector<uint32_t> _outside;
+		bool _batchDraw;
+		std::vector<float> _vertices;
+		std::string nparticleMessage;
+		cg::PropertyHandle<int> _nParticle;
+		cg::PropertyHandle<double> _minSize, _maxSize;
+		bool _isResizePending;
+
+		void spawn(ParticlePool& pool, unsigned int begin, unsigned int end);
+		void resize(cg::ComponentStore& store, unsigned int n);
+		void drawImmediate(ParticlePool& pool);
+		void drawBatch(ParticlePool& pool);
+
+	public:
+		ParticleSystem(std::string name);
+		~ParticleSystem();
+		void init(cg::ComponentStore& store);
+		void update(cg::ComponentStore& store, unsigned long elapsed_millis);
+		void run(unsigned int begin, unsigned int end);
+		void draw(cg::ComponentStore& store);
+		void drawOverlay(cg::ComponentStore& store);
+		void onPropertyChanged(const std::string& name);
+	};
+
+
+}
+
+#endif /* PARTICLESYSTEM_H_ */
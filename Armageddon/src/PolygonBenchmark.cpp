@@ -0,0 +1,60 @@
+/*
+ * PolygonBenchmark.cpp
+ */
+
+#include "PolygonBenchmark.h"
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace Armageddon {
+
+	static const unsigned int VERTICES = 24;
+	static const double RADIUS = 100.0;
+	static const uint32_t SEED = 13; // the same outline and points on every run
+
+	static void benchmarkOutline(const std::string& name, std::vector<cg::Vector2d>& outline,
+			const std::vector<float>& x, const std::vector<float>& y)
+	{
+		unsigned int n = x.size();
+		cg::Util* util = cg::Util::instance();
+		uint64_t start = cg::Clock::nanoseconds();
+		unsigned int reference = 0;
+		for (unsigned int i = 0; i < n; i++) {
+			if (util->isPointInPolygon(cg::Vector2d(x[i], y[i]), outline))
+				reference++;
+		}
+		uint64_t referenceElapsed = cg::Clock::nanoseconds() - start;
+
+		start = cg::Clock::nanoseconds();
+		cg::Polygon polygon(outline);
+		std::vector<uint32_t> hits((n + 31) / 32);
+		unsigned int batch = polygon.contains(&x[0], &y[0], n, &hits[0]);
+		uint64_t batchElapsed = cg::Clock::nanoseconds() - start;
+
+		std::ostringstream os;
+		os << "[PolygonBenchmark] " << n << " points, " << name << (polygon.isConvex() ? " (convex)" : "")
+		   << ": isPointInPolygon " << referenceElapsed * 1e-6 << " ms (" << reference << " inside), "
+		   << "cg::Polygon " << batchElapsed * 1e-6 << " ms (" << batch << " inside)";
+		cg::DebugFile::instance()->writeLine(os.str());
+	}
+
+	void benchmarkPointInPolygon(unsigned int n)
+	{
+		cg::Random random(SEED);
+		std::vector<cg::Vector2d> asteroid, convex;
+		for (unsigned int i = 0; i < VERTICES; i++) {
+			double angle = 2 * M_PI * i / VERTICES;
+			double r = random.between(0.5 * RADIUS, RADIUS);
+			asteroid.push_back(cg::Vector2d(r * cos(angle), r * sin(angle)));
+			convex.push_back(cg::Vector2d(RADIUS * cos(angle), RADIUS * sin(angle)));
+		}
+		// Points over an area four times the outline's bounding box
+		std::vector<float> x(n), y(n);
+		random.fill(&x[0], n, -2 * RADIUS, 2 * RADIUS);
+		random.fill(&y[0], n, -2 * RADIUS, 2 * RADIUS);
+		benchmarkOutline("asteroid", asteroid, x, y);
+		benchmarkOutline("regular", convex, x, y);
+	}
+
+}
@@ -0,0 +1,21 @@
+/*
+ * PolygonBenchmark.h
+ */
+
+#ifndef POLYGONBENCHMARK_H_
+#define POLYGONBENCHMARK_H_
+
+#include "cg/cg.h"
+
+namespace Armageddon {
+
+	/** Classifies n random points against an irregular asteroid-like outline
+	 *  and against a convex one, with cg::Util::isPointInPolygon and with the
+	 *  batch cg::Polygon::contains, and logs both times to the debug file.
+	 *  The batch classification itself is checked by the cglib.test project.
+	 */
+	void benchmarkPointInPolygon(unsigned int n);
+
+}
+
+#endif /* POLYGONBENCHMARK_H_ */
@@ -0,0 +1,113 @@
+/*
+ * PropertiesBenchmark.cpp
+ */
+
+#include "PropertiesBenchmark.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include "cg/cg.h"
+
+namespace Armageddon {
+
+	static const char* BENCHMARK_FILE = "properties_benchmark.ini";
+	static const uint32_t SEED = 19; // the same file on every run
+
+	typedef std::map<std::string, std::string> tPropertyMap;
+
+	// The line parser cg::Properties used before it split files in place
+	static void parseLineWithStreams(const std::string& line, tPropertyMap& properties)
+	{
+		std::string name, value, separator;
+		std::istringstream iss(line);
+		if (line.size() > 0) {
+			iss >> name >> separator;
+			if (name[0] == '#')
+				return;
+			value = iss.str().substr(iss.tellg());
+			if (separator == "=") {
+				size_t start = value.find_first_not_of(" ");
+				size_t end = value.find_last_not_of(" ");
+				properties.insert(std::make_pair(name, value.substr(start, end - start + 1)));
+			}
+		}
+	}
+
+	static void readWithStreams(const std::string& filename, tPropertyMap& properties)
+	{
+		std::string line;
+		std::ifstream file(filename.c_str());
+		while (!file.eof()) {
+			std::getline(file, line);
+			parseLineWithStreams(line, properties);
+		}
+	}
+
+	static void writeFile(const std::string& filename, unsigned int lines)
+	{
+		cg::Random random(SEED);
+		std::ofstream file(filename.c_str());
+		for (unsigned int i = 0; i < lines; i++) {
+			switch (i % 5) {
+			case 0:
+				file << "# generated line " << i << "\n";
+				break;
+			case 1:
+				file << "LEVEL_COUNT_" << i << " = " << (int)random.between(-100000, 100000) << "\n";
+				break;
+			case 2:
+				file << "LEVEL_SCALE_" << i << " = " << random.between(-1000, 1000) << "\n";
+				break;
+			case 3:
+				file << "LEVEL_SIZE_" << i << " = " << random.between(0, 100) << " " << random.between(0, 100) << "\n";
+				break;
+			default:
+				file << "LEVEL_NAME_" << i << " =   entity " << i << "  \n";
+				break;
+			}
+		}
+	}
+
+	void benchmarkPropertiesLoad(unsigned int lines)
+	{
+		writeFile(BENCHMARK_FILE, lines);
+
+		tPropertyMap streams, sliced;
+		uint64_t start = cg::Clock::nanoseconds();
+		readWithStreams(BENCHMARK_FILE, streams);
+		uint64_t streams_read = cg::Clock::nanoseconds() - start;
+		start = cg::Clock::nanoseconds();
+		cg::Properties::read(BENCHMARK_FILE, sliced);
+		uint64_t sliced_read = cg::Clock::nanoseconds() - start;
+		std::remove(BENCHMARK_FILE);
+
+		// converts every value, as getDouble would, counting the convertible ones
+		unsigned int numbers = 0;
+		start = cg::Clock::nanoseconds();
+		for (tPropertyMap::iterator i = streams.begin(); i != streams.end(); i++) {
+			std::istringstream iss(i->second);
+			double d;
+			iss >> d;
+		}
+		uint64_t streams_convert = cg::Clock::nanoseconds() - start;
+		start = cg::Clock::nanoseconds();
+		for (tPropertyMap::iterator i = sliced.begin(); i != sliced.end(); i++) {
+			double d;
+			if (cg::Properties::parse(i->second, d))
+				numbers++;
+		}
+		uint64_t sliced_convert = cg::Clock::nanoseconds() - start;
+
+		std::ostringstream os;
+		os << "[PropertiesBenchmark] " << lines << " lines, " << sliced.size() << " properties: read with streams "
+		   << streams_read * 1e-6 << " ms, sliced " << sliced_read * 1e-6 << " ms";
+		cg::DebugFile::instance()->writeLine(os.str());
+		os.str("");
+		os << "[PropertiesBenchmark] " << numbers << " numbers: istringstream " << streams_convert * 1e-6
+		   << " ms, strtod " << sliced_convert * 1e-6 << " ms";
+		cg::DebugFile::instance()->writeLine(os.str());
+	}
+
+}
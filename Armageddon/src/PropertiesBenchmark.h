@@ -0,0 +1,21 @@
+/*
+ * PropertiesBenchmark.h
+ */
+
+#ifndef PROPERTIESBENCHMARK_H_
+#define PROPERTIESBENCHMARK_H_
+
+namespace Armageddon {
+
+	/** Writes a properties file of the given number of lines, reads it back
+	 *  with the former std::getline and std::istringstream parser and with
+	 *  cg::Properties::read, converts every value to a double with
+	 *  std::istringstream and with cg::Properties::parse, and logs the time
+	 *  taken by each to the debug file. That both agree is checked by the
+	 *  cglib.test project.
+	 */
+	void benchmarkPropertiesLoad(unsigned int lines);
+
+}
+
+#endif /* PROPERTIESBENCHMARK_H_ */
@@ -0,0 +1,68 @@
+/*
+ * QuaternionBenchmark.cpp
+ */
+
+#include "QuaternionBenchmark.h"
+#include <cmath>
+#include <sstream>
+#include <vector>
+#include "cg/cg.h"
+
+namespace Armageddon {
+
+	static const float SLERP_T = 0.3f;
+	static const uint32_t SEED = 17; // the same quaternions on every run
+
+	static void logResult(const std::string& name, unsigned int n, uint64_t scalar, uint64_t batch)
+	{
+		std::ostringstream os;
+		os << "[QuaternionBenchmark] " << n << " quaternions, " << name << ": Quaternionf " << scalar * 1e-6
+		   << " ms, QuaternionArray " << batch * 1e-6 << " ms";
+		cg::DebugFile::instance()->writeLine(os.str());
+	}
+
+	static cg::Quaternionf randomUnit(cg::Random& random)
+	{
+		cg::Quaternionf q(random.between(-1, 1), random.between(-1, 1), random.between(-1, 1), random.between(-1, 1));
+		return q * (1 / sqrtf(norm(q)));
+	}
+
+	void benchmarkQuaternions(unsigned int n)
+	{
+		cg::Random random(SEED);
+		std::vector<cg::Quaternionf> a(n), b(n), result(n);
+		cg::QuaternionArray qa(n), qb(n), batchResult;
+		for (unsigned int i = 0; i < n; i++) {
+			a[i] = randomUnit(random);
+			b[i] = randomUnit(random);
+			qa.set(i, a[i]);
+			qb.set(i, b[i]);
+		}
+
+		uint64_t start = cg::Clock::nanoseconds();
+		for (unsigned int i = 0; i < n; i++)
+			result[i] = a[i] * b[i];
+		uint64_t scalar = cg::Clock::nanoseconds() - start;
+		start = cg::Clock::nanoseconds();
+		batchResult.multiply(qa, qb);
+		logResult("multiply", n, scalar, cg::Clock::nanoseconds() - start);
+
+		start = cg::Clock::nanoseconds();
+		for (unsigned int i = 0; i < n; i++)
+			result[i] = slerp(a[i], b[i], SLERP_T);
+		scalar = cg::Clock::nanoseconds() - start;
+		start = cg::Clock::nanoseconds();
+		batchResult.slerp(qa, qb, SLERP_T);
+		logResult("slerp", n, scalar, cg::Clock::nanoseconds() - start);
+
+		std::vector<float> matrices(16 * n);
+		start = cg::Clock::nanoseconds();
+		for (unsigned int i = 0; i < n; i++)
+			a[i].getGLMatrix(&matrices[16 * i]);
+		scalar = cg::Clock::nanoseconds() - start;
+		start = cg::Clock::nanoseconds();
+		qa.getGLMatrices(&matrices[0]);
+		logResult("matrices", n, scalar, cg::Clock::nanoseconds() - start);
+	}
+
+}
@@ -0,0 +1,19 @@
+/*
+ * QuaternionBenchmark.h
+ */
+
+#ifndef QUATERNIONBENCHMARK_H_
+#define QUATERNIONBENCHMARK_H_
+
+namespace Armageddon {
+
+	/** Multiplies, slerps and converts to matrices n random unit quaternions
+	 *  one at a time with cg::Quaternionf and in batch with
+	 *  cg::QuaternionArray, and logs the time taken by each to the debug
+	 *  file. The batch results are checked by the cglib.test project.
+	 */
+	void benchmarkQuaternions(unsigned int n);
+
+}
+
+#endif /* QUATERNIONBENCHMARK_H_ */
@@ -0,0 +1,59 @@
+/*
+ * VectorBenchmark.cpp
+ */
+
+#include "VectorBenchmark.h"
+#include <sstream>
+#include <vector>
+#include "cg/cg.h"
+
+namespace Armageddon {
+
+	static const unsigned int STEPS = 100;
+
+	template <class V>
+	static uint64_t integrate(unsigned int n)
+	{
+		std::vector<V> position(n), velocity(n, V(1, 2, 3));
+		V gravity(0, -9.8, 0);
+		double dt = 0.008;
+		uint64_t start = cg::Clock::nanoseconds();
+		for (unsigned int s = 0; s < STEPS; s++) {
+			for (unsigned int i = 0; i < n; i++) {
+				velocity[i] += gravity * dt;
+				position[i] += normalize(velocity[i]) * dt;
+			}
+		}
+		return cg::Clock::nanoseconds() - start;
+	}
+
+	static uint64_t stream(unsigned int n)
+	{
+		std::vector<cg::Vector3d> position(n), velocity(n, cg::Vector3d(1, 2, 3)), acceleration(n, cg::Vector3d(0, -9.8, 0));
+		double dt = 0.008;
+		uint64_t start = cg::Clock::nanoseconds();
+		for (unsigned int i = 0; i < n; i++)
+			position[i] = position[i] + velocity[i] * dt + acceleration[i] * (dt * dt / 2);
+		for (unsigned int i = 0; i < n; i++)
+			velocity[i] -= acceleration[i] * dt;
+		return cg::Clock::nanoseconds() - start;
+	}
+
+	void benchmarkVectors(unsigned int n)
+	{
+		std::ostringstream os;
+		os << "[VectorBenchmark] " << n << " particles x " << STEPS << " steps (" << cg::Vector3da::tLanes::getISA()
+		   << "): Vector3d "
+		   << integrate<cg::Vector3d>(n) * 1e-6 << " ms, Vector3da " << integrate<cg::Vector3da>(n) * 1e-6 << " ms";
+		cg::DebugFile::instance()->writeLine(os.str());
+		os.str("");
+#ifdef CG_VECTOR_EXPRESSIONS
+		os << "[VectorBenchmark] " << n << " element stream, expression templates: ";
+#else
+		os << "[VectorBenchmark] " << n << " element stream, temporaries: ";
+#endif
+		os << stream(n) * 1e-6 << " ms";
+		cg::DebugFile::instance()->writeLine(os.str());
+	}
+
+}
@@ -0,0 +1,21 @@
+/*
+ * VectorBenchmark.h
+ */
+
+#ifndef VECTORBENCHMARK_H_
+#define VECTORBENCHMARK_H_
+
+namespace Armageddon {
+
+	/** Times a simple integration step over n particles with cg::Vector3d
+	 *  and cg::Vector3da, and a compound cg::Vector3d expression over an
+	 *  n element stream (compare builds with and without
+	 *  CG_VECTOR_EXPRESSIONS). Logs the results, along with the instruction
+	 *  set cglib was compiled for (see CG_SIMD), to the debug file. The
+	 *  cg::AlignedVector results are checked by the cglib.test project.
+	 */
+	void benchmarkVectors(unsigned int n);
+
+}
+
+#endif /* VECTORBENCHMARK_H_ */
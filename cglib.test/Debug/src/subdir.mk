@@ -0,0 +1,53 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../src/AlignedVectorTest.cpp \
+../src/ComponentStoreTest.cpp \
+../src/LockableOrderedMapTest.cpp \
+../src/PolygonTest.cpp \
+../src/PropertiesTest.cpp \
+../src/QuaternionArrayTest.cpp \
+../src/RegistryTest.cpp \
+../src/SpatialGridTest.cpp \
+../src/ThreadPoolTest.cpp \
+../src/UtilTest.cpp \
+../src/main.cpp 
+
+OBJS += \
+./src/AlignedVectorTest.o \
+./src/ComponentStoreTest.o \
+./src/LockableOrderedMapTest.o \
+./src/PolygonTest.o \
+./src/PropertiesTest.o \
+./src/QuaternionArrayTest.o \
+./src/RegistryTest.o \
+./src/SpatialGridTest.o \
+./src/ThreadPoolTest.o \
+./src/UtilTest.o \
+./src/main.o 
+
+CPP_DEPS += \
+./src/AlignedVectorTest.d \
+./src/ComponentStoreTest.d \
+./src/LockableOrderedMapTest.d \
+./src/PolygonTest.d \
+./src/PropertiesTest.d \
+./src/QuaternionArrayTest.d \
+./src/RegistryTest.d \
+./src/SpatialGridTest.d \
+./src/ThreadPoolTest.d \
+./src/UtilTest.d \
+./src/main.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+src/%.o: ../src/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ -I"../../cglib/src" -O0 -g3 -pedantic -pedantic-errors -Wall -Werror -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o"$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
@@ -0,0 +1,97 @@
+/*
+ * AlignedVectorTest.cpp
+ */
+
+#include "AlignedVectorTest.h"
+#include <cstring>
+
+namespace cglibtest {
+
+	static const unsigned int VECTORS = 1000;
+
+	template <class T>
+	static bool isSame(const T* a, const T* b, unsigned int n)
+	{
+		return memcmp(a, b, n * sizeof(T)) == 0;
+	}
+
+	AlignedVectorTest::AlignedVectorTest()
+		: cg::Test(std::string("cg::AlignedVector (") + cg::Vector3da::tLanes::getISA() + ")"), _random(17)
+	{
+	}
+
+	template <class T, int D>
+	void AlignedVectorTest::checkVectors(unsigned int n)
+	{
+		typedef cg::AlignedVector<T,D> A;
+		typedef typename A::tVector V;
+		unsigned int mismatches = 0;
+		for (unsigned int t = 0; t < n; t++) {
+			V a, b;
+			for (int i = 0; i < D; i++) {
+				a[i] = (T)_random.between(-1000, 1000);
+				b[i] = (T)_random.between(-1000, 1000);
+			}
+			T k = (T)_random.between(0.1, 10);
+			A x(a), y(b);
+			V r[8] = { a + b, a - b, a * b, a / b, a * k, a / k, -a, normalize(a) };
+			A s[8] = { x + y, x - y, x * y, x / y, x * k, x / k, -x, normalize(x) };
+			for (int j = 0; j < 8; j++) {
+				if (!isSame(r[j].data, s[j].data, D))
+					mismatches++;
+			}
+			a += b;
+			a *= k;
+			x += y;
+			x *= k;
+			T d0 = dot(a, b), d1 = dot(x, y);
+			double l0 = length(a), l1 = length(x);
+			if (!isSame(a.data, x.data, D) || !isSame(&d0, &d1, 1) || !isSame(&l0, &l1, 1))
+				mismatches++;
+		}
+		CHECK(mismatches == 0)
+	}
+
+	template <class T>
+	void AlignedVectorTest::checkCross(unsigned int n)
+	{
+		unsigned int mismatches = 0;
+		for (unsigned int t = 0; t < n; t++) {
+			cg::Vector3<T> a, b;
+			for (int i = 0; i < 3; i++) {
+				a[i] = (T)_random.between(-1000, 1000);
+				b[i] = (T)_random.between(-1000, 1000);
+			}
+			cg::Vector3<T> r = cross(a, b);
+			cg::AlignedVector<T,3> s = cross(cg::AlignedVector<T,3>(a), cg::AlignedVector<T,3>(b));
+			if (!isSame(r.data, s.data, 3))
+				mismatches++;
+		}
+		CHECK(mismatches == 0)
+	}
+
+	void AlignedVectorTest::testVector2da()
+	{
+		checkVectors<double,2>(VECTORS);
+	}
+
+	void AlignedVectorTest::testVector3fa()
+	{
+		checkVectors<float,3>(VECTORS);
+		checkCross<float>(VECTORS);
+	}
+
+	void AlignedVectorTest::testVector3da()
+	{
+		checkVectors<double,3>(VECTORS);
+		checkCross<double>(VECTORS);
+	}
+
+	void AlignedVectorTest::test()
+	{
+		TEST(testVector2da)
+		TEST(testVector3fa)
+		TEST(testVector3da)
+	}
+
+}
@@ -0,0 +1,38 @@
+/*
+ * AlignedVectorTest.h
+ */
+
+#ifndef ALIGNEDVECTORTEST_H_
+#define ALIGNEDVECTORTEST_H_
+
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks that the cg::AlignedVector operations give bit-identical
+	 *  results to the cg::Vector ones on random vectors of each type. The
+	 *  lanes used depend on CG_SIMD: the Debug configuration tests the
+	 *  generic lanes, and the DebugSimd configuration the SSE (or, with
+	 *  -mavx, AVX) ones.
+	 */
+	class AlignedVectorTest : public cg::Test {
+	private:
+		cg::Random _random;
+
+		template <class T, int D>
+		void checkVectors(unsigned int n);
+		template <class T>
+		void checkCross(unsigned int n);
+
+		void testVector2da();
+		void testVector3fa();
+		void testVector3da();
+
+	public:
+		AlignedVectorTest();
+		void test();
+	};
+
+}
+
+#endif /* ALIGNEDVECTORTEST_H_ */
@@ -0,0 +1,162 @@
+/*
+ * ComponentStoreTest.cpp
+ */
+
+#include "ComponentStoreTest.h"
+#include <map>
+#include <vector>
+
+namespace cglibtest {
+
+	typedef struct {
+		float x, y;
+	} tPosition;
+
+	typedef struct {
+		int value;
+	} tTag;
+
+	// Destroys, while iterating them, the entities with an odd tag, and
+	// checks they are still alive until the end of the step.
+	class OddTagSystem : public cg::ComponentSystem {
+	public:
+		unsigned int visited;
+		bool isAliveDuringStep;
+
+		OddTagSystem() : cg::ComponentSystem("OddTag"), visited(0), isAliveDuringStep(true) {}
+		void update(cg::ComponentStore& store, unsigned long elapsed_millis) {
+			cg::ComponentArray<tTag>& tags = store.getComponents<tTag>();
+			for (unsigned int i = 0; i < tags.size(); i++) {
+				cg::ComponentId id = store.getId(tags.entityAt(i));
+				if (tags.at(i).value % 2 != 0) {
+					store.destroyLater(id);
+					store.destroyLater(id);
+				}
+				isAliveDuringStep = isAliveDuringStep && store.isAlive(id);
+				visited++;
+			}
+		}
+	};
+
+	ComponentStoreTest::ComponentStoreTest() : cg::Test("cg::ComponentStore")
+	{
+	}
+
+	void ComponentStoreTest::testStaleId()
+	{
+		cg::ComponentStore store("ComponentStoreTest");
+		cg::ComponentId a = store.create();
+		tTag tag = { 1 };
+		store.addComponent(a, tag);
+		CHECK(store.isAlive(a))
+		CHECK(store.size() == 1)
+		store.destroy(a);
+		CHECK(!store.isAlive(a))
+		CHECK(store.getComponent<tTag>(a) == 0)
+		CHECK(store.size() == 0)
+
+		cg::ComponentId b = store.create();
+		CHECK(b.index == a.index)
+		CHECK(b.generation == cg::EntityHandle::nextGeneration(a.generation))
+		CHECK(!store.isAlive(a))
+		CHECK(store.getComponent<tTag>(b) == 0)
+		CHECK(!store.hasComponent<tTag>(a))
+		TEST_EXCEPTION(std::runtime_error, store.addComponent(a, tag))
+		store.removeComponent<tTag>(a);
+		store.destroy(a);
+		CHECK(store.isAlive(b))
+		CHECK(store.size() == 1)
+		CHECK(store.getId(b.index) == b)
+	}
+
+	// Every live entity must find its own components, and every dense slot
+	// must belong to a live entity that finds it.
+	void ComponentStoreTest::testSwapRemove()
+	{
+		cg::ComponentStore store("ComponentStoreTest");
+		cg::Random random(37);
+		std::vector<cg::ComponentId> alive;
+		std::map<uint32_t, int> tags;
+		std::map<uint32_t, float> positions;
+		int next = 0;
+		bool consistent = true;
+		for (unsigned int step = 0; step < 2000; step++) {
+			double action = random.nextDouble();
+			if (action < 0.5 || alive.empty()) {
+				cg::ComponentId id = store.create();
+				tTag tag = { next };
+				store.addComponent(id, tag);
+				tags[id.index] = next;
+				if (next % 3 != 0) {
+					tPosition position = { (float)next, (float)-next };
+					store.addComponent(id, position);
+					positions[id.index] = (float)next;
+				}
+				next++;
+				alive.push_back(id);
+			} else {
+				unsigned int k = (unsigned int)random.between(0, alive.size());
+				cg::ComponentId id = alive[k];
+				if (action < 0.8) {
+					store.destroy(id);
+					tags.erase(id.index);
+					positions.erase(id.index);
+					alive[k] = alive.back();
+					alive.pop_back();
+				} else {
+					store.removeComponent<tPosition>(id);
+					positions.erase(id.index);
+				}
+			}
+
+			cg::ComponentArray<tTag>& tag_array = store.getComponents<tTag>();
+			cg::ComponentArray<tPosition>& position_array = store.getComponents<tPosition>();
+			consistent = consistent && store.size() == alive.size()
+					&& tag_array.size() == tags.size() && position_array.size() == positions.size();
+			for (unsigned int i = 0; i < alive.size(); i++) {
+				tTag* tag = store.getComponent<tTag>(alive[i]);
+				tPosition* position = store.getComponent<tPosition>(alive[i]);
+				consistent = consistent && tag && tag->value == tags[alive[i].index];
+				if (positions.count(alive[i].index))
+					consistent = consistent && position && position->x == positions[alive[i].index];
+				else
+					consistent = consistent && position == 0;
+			}
+			for (unsigned int slot = 0; slot < position_array.size(); slot++)
+				consistent = consistent && position_array.get(position_array.entityAt(slot)) == &position_array.at(slot);
+		}
+		CHECK(consistent)
+	}
+
+	void ComponentStoreTest::testDestroyLater()
+	{
+		cg::ComponentStore store("ComponentStoreTest");
+		OddTagSystem* system = new OddTagSystem();
+		store.addSystem(system);
+		std::vector<cg::ComponentId> ids;
+		for (int i = 0; i < 100; i++) {
+			ids.push_back(store.create());
+			tTag tag = { i };
+			store.addComponent(ids.back(), tag);
+		}
+		store.update(0);
+		CHECK(system->visited == 100)
+		CHECK(system->isAliveDuringStep)
+		CHECK(store.size() == 50)
+		bool survivors = true;
+		for (int i = 0; i < 100; i++)
+			survivors = survivors && store.isAlive(ids[i]) == (i % 2 == 0);
+		CHECK(survivors)
+		store.update(0);
+		CHECK(system->visited == 150)
+		CHECK(store.size() == 50)
+	}
+
+	void ComponentStoreTest::test()
+	{
+		TEST(testStaleId)
+		TEST(testSwapRemove)
+		TEST(testDestroyLater)
+	}
+
+}
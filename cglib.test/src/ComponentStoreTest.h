@@ -0,0 +1,32 @@
+/*
+ * ComponentStoreTest.h
+ */
+
+#ifndef COMPONENTSTORETEST_H_
+#define COMPONENTSTORETEST_H_
+
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks cg::ComponentStore against a plain map of the live entities:
+	 *  ids of destroyed entities are stale even once their index is reused,
+	 *  random creations, destructions and component removals keep every
+	 *  component with its entity while the dense arrays are swapped and
+	 *  popped, and entities destroyed with destroyLater stay alive until the
+	 *  end of the step.
+	 */
+	class ComponentStoreTest : public cg::Test {
+	private:
+		void testStaleId();
+		void testSwapRemove();
+		void testDestroyLater();
+
+	public:
+		ComponentStoreTest();
+		void test();
+	};
+
+}
+
+#endif /* COMPONENTSTORETEST_H_ */
@@ -0,0 +1,258 @@
+/*
+ * LockableOrderedMapTest.cpp
+ */
+
+#include "LockableOrderedMapTest.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace cglibtest {
+
+	// Counts its live instances, to tell destroyed elements from leaked ones.
+	struct Element {
+		static int alive;
+		int value;
+		Element(int v) : value(v) { alive++; }
+		~Element() { alive--; }
+	};
+	int Element::alive = 0;
+
+	typedef cg::LockableOrderedMap<Element> tMap;
+
+	static const unsigned int ELEMENTS = 200;
+
+	static std::string getName(int value)
+	{
+		std::ostringstream os;
+		os << "e" << value;
+		return os.str();
+	}
+
+	// The values in iteration order, and every name found with its element.
+	static std::vector<int> getValues(tMap& map)
+	{
+		std::vector<int> values;
+		for (tMap::iterator i = map.begin(); i != map.end(); i++)
+			values.push_back((*i)->value);
+		return values;
+	}
+
+	static bool isConsistent(tMap& map, const std::vector<int>& values)
+	{
+		if (map.size() != values.size())
+			return false;
+		for (unsigned int i = 0; i < values.size(); i++) {
+			Element* element = map.get(getName(values[i]));
+			if (element == 0 || element->value != values[i])
+				return false;
+		}
+		return true;
+	}
+
+	LockableOrderedMapTest::LockableOrderedMapTest() : cg::Test("cg::LockableOrderedMap")
+	{
+	}
+
+	// Random removals and re-additions, some applied on unlock, must keep
+	// the insertion order of a plain list.
+	void LockableOrderedMapTest::testPreserveOrder()
+	{
+		cg::Random random(23);
+		std::vector<Element*> elements;
+		for (unsigned int i = 0; i < ELEMENTS; i++)
+			elements.push_back(new Element(i));
+		tMap map;
+		CHECK(map.isPreservingOrder())
+		std::vector<int> expected;
+		for (unsigned int i = 0; i < ELEMENTS; i++) {
+			map.add(getName(i), elements[i]);
+			expected.push_back(i);
+		}
+		bool order = true, consistent = true;
+		for (unsigned int round = 0; round < 20; round++) {
+			bool is_locked = (round % 2 == 1);
+			if (is_locked)
+				map.lock();
+			for (unsigned int r = 0; r < 10 && !expected.empty(); r++) {
+				unsigned int k = (unsigned int)random.between(0, expected.size());
+				map.remove(getName(expected[k]));
+				expected.erase(expected.begin() + k);
+			}
+			for (unsigned int a = 0; a < 5; a++) {
+				int value = (int)random.between(0, ELEMENTS);
+				if (std::find(expected.begin(), expected.end(), value) == expected.end()) {
+					map.add(getName(value), elements[value]);
+					expected.push_back(value);
+				}
+			}
+			if (is_locked)
+				map.unlock();
+			order = order && getValues(map) == expected;
+			consistent = consistent && isConsistent(map, expected);
+		}
+		CHECK(order)
+		CHECK(consistent)
+		map.removeAll();
+		CHECK(map.size() == 0)
+		CHECK(map.begin() == map.end())
+		for (unsigned int i = 0; i < ELEMENTS; i++)
+			delete elements[i];
+	}
+
+	// A removal moves the last element into the freed slot, and the name
+	// of the moved element must follow it.
+	void LockableOrderedMapTest::testSwapRemove()
+	{
+		std::vector<Element*> elements;
+		for (unsigned int i = 0; i < 5; i++)
+			elements.push_back(new Element(i));
+		tMap map;
+		for (unsigned int i = 0; i < 3; i++)
+			map.add(getName(i), elements[i]);
+		map.remove("e1");
+		map.setPreserveOrder(false);
+		CHECK(!map.isPreservingOrder())
+		map.add("e3", elements[3]);
+		map.add("e4", elements[4]);
+
+		int swapped[] = { 0, 2, 4 };
+		map.remove("e3");
+		CHECK(getValues(map) == std::vector<int>(swapped, swapped + 3))
+		map.remove("e0");
+		int popped[] = { 4, 2 };
+		CHECK(getValues(map) == std::vector<int>(popped, popped + 2))
+		CHECK(isConsistent(map, getValues(map)))
+		map.remove("e2");
+		CHECK(getValues(map) == std::vector<int>(1, 4))
+		map.add("e0", elements[0]);
+		map.remove("e4");
+		CHECK(getValues(map) == std::vector<int>(1, 0))
+		CHECK(map.get("e0") == elements[0])
+		CHECK(map.get("e4") == 0)
+		map.remove("e0");
+		CHECK(map.size() == 0)
+		for (unsigned int i = 0; i < 5; i++)
+			delete elements[i];
+	}
+
+	void LockableOrderedMapTest::testVersion()
+	{
+		Element a(1), b(2);
+		tMap map;
+		unsigned long version = map.getVersion();
+		map.add("a", &a);
+		CHECK(map.getVersion() != version)
+		version = map.getVersion();
+		map.remove("missing");
+		map.begin();
+		CHECK(map.getVersion() == version)
+		map.lock();
+		map.add("b", &b);
+		map.remove("a");
+		CHECK(map.getVersion() == version)
+		map.unlock();
+		CHECK(map.getVersion() != version)
+		version = map.getVersion();
+		map.setPreserveOrder(false);
+		CHECK(map.getVersion() == version)
+		map.removeAll();
+		CHECK(map.getVersion() != version)
+	}
+
+	void LockableOrderedMapTest::testLockedAdd()
+	{
+		tMap map;
+		Element a(1);
+		map.lock();
+		map.add("a", &a);
+		CHECK(map.exists("a"))
+		CHECK(map.get("a") == &a)
+		CHECK(map.size() == 0)
+		TEST_EXCEPTION(std::runtime_error, map.add("a", &a))
+		map.unlock();
+		CHECK(map.size() == 1)
+		CHECK(map.get("a") == &a)
+	}
+
+	// lock, add an existing name, remove it, unlock: the add throws at once,
+	// and the removal queued after it is still applied.
+	void LockableOrderedMapTest::testLockedDuplicate()
+	{
+		tMap map;
+		Element a(1), b(2), c(3);
+		map.add("a", &a);
+		map.lock();
+		TEST_EXCEPTION(std::runtime_error, map.add("a", &b))
+		map.remove("a");
+		map.add("c", &c);
+		map.unlock();
+		CHECK(!map.exists("a"))
+		CHECK(map.get("c") == &c)
+		CHECK(map.size() == 1)
+	}
+
+	void LockableOrderedMapTest::testLockedReAdd()
+	{
+		tMap map;
+		Element a(1), b(2);
+		map.add("a", &a);
+		map.lock();
+		map.remove("a");
+		CHECK(!map.exists("a"))
+		CHECK(map.get("a") == 0)
+		map.add("a", &b);
+		CHECK(map.get("a") == &b)
+		map.unlock();
+		CHECK(map.get("a") == &b)
+		CHECK(map.size() == 1)
+
+		map.lock();
+		map.add("c", &a);
+		map.remove("c");
+		CHECK(!map.exists("c"))
+		map.add("c", &a);
+		map.removeAll();
+		CHECK(!map.exists("a"))
+		CHECK(!map.exists("c"))
+		map.add("a", &a);
+		map.unlock();
+		CHECK(map.get("a") == &a)
+		CHECK(map.size() == 1)
+	}
+
+	void LockableOrderedMapTest::testLockedDestroy()
+	{
+		int alive = Element::alive;
+		{
+			tMap map;
+			map.add("a", new Element(1));
+			map.add("b", new Element(2));
+			map.lock();
+			map.destroy("a");
+			Element* c = new Element(3);
+			map.add("c", c);
+			TEST_EXCEPTION(std::runtime_error, map.add("b", c))
+			CHECK(Element::alive == alive + 3)
+			map.unlock();
+			CHECK(Element::alive == alive + 2)
+			map.lock();
+			map.destroyAll();
+			map.unlock();
+			CHECK(map.size() == 0)
+		}
+		CHECK(Element::alive == alive)
+	}
+
+	void LockableOrderedMapTest::test()
+	{
+		TEST(testPreserveOrder)
+		TEST(testSwapRemove)
+		TEST(testVersion)
+		TEST(testLockedAdd)
+		TEST(testLockedDuplicate)
+		TEST(testLockedReAdd)
+		TEST(testLockedDestroy)
+	}
+
+}
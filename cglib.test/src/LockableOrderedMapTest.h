@@ -0,0 +1,38 @@
+/*
+ * LockableOrderedMapTest.h
+ */
+
+#ifndef LOCKABLEORDEREDMAPTEST_H_
+#define LOCKABLEORDEREDMAPTEST_H_
+
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks cg::LockableOrderedMap against a plain list of names: the
+	 *  iteration order with and without setPreserveOrder (tombstones and
+	 *  their compaction, or swap and pop), name lookups after elements moved
+	 *  slot, removal and re-addition, and the version. Also checks the
+	 *  commands queued on a locked map: names added or removed while locked
+	 *  are seen by exists and get at once, adding an existing name throws
+	 *  from add, and the commands queued around a rejected add are all
+	 *  applied on unlock.
+	 */
+	class LockableOrderedMapTest : public cg::Test {
+	private:
+		void testPreserveOrder();
+		void testSwapRemove();
+		void testVersion();
+		void testLockedAdd();
+		void testLockedDuplicate();
+		void testLockedReAdd();
+		void testLockedDestroy();
+
+	public:
+		LockableOrderedMapTest();
+		void test();
+	};
+
+}
+
+#endif /* LOCKABLEORDEREDMAPTEST_H_ */
@@ -0,0 +1,118 @@
+/*
+ * PolygonTest.cpp
+ */
+
+#include "PolygonTest.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cglibtest {
+
+	static const unsigned int VERTICES = 24;
+	static const double RADIUS = 100.0;
+	static const unsigned int LENGTHS[] = { 0, 1, 31, 32, 33, 64, 100, 1000 };
+	static const unsigned int LENGTH_COUNT = sizeof(LENGTHS) / sizeof(LENGTHS[0]);
+
+	PolygonTest::PolygonTest() : cg::Test("cg::Polygon")
+	{
+	}
+
+	// Points closer than this to an edge may be classified differently in
+	// single and double precision.
+	bool PolygonTest::isNearBoundary(float x, float y) const
+	{
+		for (unsigned int i = 0, j = _outline.size() - 1; i < _outline.size(); j = i++) {
+			cg::Vector2d edge = _outline[i] - _outline[j];
+			cg::Vector2d point = cg::Vector2d(x, y) - _outline[j];
+			double t = std::max(0.0, std::min(1.0, dot(point, edge) / dot(edge, edge)));
+			if (length(point - edge * t) < 1e-3)
+				return true;
+		}
+		return false;
+	}
+
+	void PolygonTest::checkOutline()
+	{
+		cg::Polygon polygon(_outline);
+		cg::Util* util = cg::Util::instance();
+		std::vector<std::string> kernels = cg::Polygon::getContainsKernels();
+		for (unsigned int k = 0; k < kernels.size(); k++) {
+			CHECK(cg::Polygon::setContainsKernel(kernels[k]))
+			for (unsigned int l = 0; l < LENGTH_COUNT; l++) {
+				unsigned int n = LENGTHS[l];
+				std::vector<uint32_t> hits((n + 31) / 32 + 1, 0xffffffffu);
+				unsigned int count = polygon.contains(&_x[0], &_y[0], n, &hits[0]);
+				unsigned int expected = 0;
+				bool match = true, reference = true;
+				for (unsigned int i = 0; i < n; i++) {
+					bool inside = polygon.contains(_x[i], _y[i]);
+					if (inside)
+						expected++;
+					if (inside != (((hits[i / 32] >> (i % 32)) & 1) != 0))
+						match = false;
+					if (!isNearBoundary(_x[i], _y[i])
+							&& inside != util->isPointInPolygon(cg::Vector2d(_x[i], _y[i]), _outline))
+						reference = false;
+				}
+				CHECK(match)
+				CHECK(reference)
+				CHECK(count == expected)
+				if (n % 32 != 0)
+					CHECK((hits[n / 32] >> (n % 32)) == 0)
+				CHECK(hits[(n + 31) / 32] == 0xffffffffu)
+			}
+		}
+		cg::Polygon::setContainsKernel(kernels.back());
+	}
+
+	// An asteroid-like outline, with points over four times its bounding box
+	// and on its vertices.
+	void PolygonTest::testConcave()
+	{
+		cg::Random random(11);
+		_outline.clear();
+		for (unsigned int i = 0; i < VERTICES; i++) {
+			double angle = 2 * M_PI * i / VERTICES;
+			double r = random.between(0.5 * RADIUS, RADIUS);
+			_outline.push_back(cg::Vector2d(r * cos(angle), r * sin(angle)));
+		}
+		_x.resize(LENGTHS[LENGTH_COUNT - 1]);
+		_y.resize(LENGTHS[LENGTH_COUNT - 1]);
+		random.fill(&_x[0], _x.size(), -2 * RADIUS, 2 * RADIUS);
+		random.fill(&_y[0], _y.size(), -2 * RADIUS, 2 * RADIUS);
+		for (unsigned int i = 0; i < VERTICES; i++) {
+			_x[3 * i] = (float)_outline[i][0];
+			_y[3 * i] = (float)_outline[i][1];
+		}
+		CHECK(!cg::Polygon(_outline).isConvex())
+		checkOutline();
+	}
+
+	// A regular outline, with points on the edges of its bounding box.
+	void PolygonTest::testConvex()
+	{
+		cg::Random random(13);
+		_outline.clear();
+		for (unsigned int i = 0; i < VERTICES; i++) {
+			double angle = 2 * M_PI * i / VERTICES;
+			_outline.push_back(cg::Vector2d(RADIUS * cos(angle), RADIUS * sin(angle)));
+		}
+		_x.resize(LENGTHS[LENGTH_COUNT - 1]);
+		_y.resize(LENGTHS[LENGTH_COUNT - 1]);
+		random.fill(&_x[0], _x.size(), -2 * RADIUS, 2 * RADIUS);
+		random.fill(&_y[0], _y.size(), -2 * RADIUS, 2 * RADIUS);
+		for (unsigned int i = 0; i < 2 * VERTICES; i += 2) {
+			_x[i] = (float)RADIUS;
+			_y[i + 1] = (float)-RADIUS;
+		}
+		CHECK(cg::Polygon(_outline).isConvex())
+		checkOutline();
+	}
+
+	void PolygonTest::test()
+	{
+		TEST(testConcave)
+		TEST(testConvex)
+	}
+
+}
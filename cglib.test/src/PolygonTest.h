@@ -0,0 +1,37 @@
+/*
+ * PolygonTest.h
+ */
+
+#ifndef POLYGONTEST_H_
+#define POLYGONTEST_H_
+
+#include <vector>
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks the batch cg::Polygon::contains, with every kernel the CPU
+	 *  supports, against the single point cg::Polygon::contains, which uses
+	 *  the same single precision edge data, and against
+	 *  cg::Util::isPointInPolygon away from the boundary, on a concave and
+	 *  a convex outline and on lengths that leave a partial last hit word.
+	 */
+	class PolygonTest : public cg::Test {
+	private:
+		std::vector<cg::Vector2d> _outline;
+		std::vector<float> _x, _y;
+
+		bool isNearBoundary(float x, float y) const;
+		void checkOutline();
+
+		void testConcave();
+		void testConvex();
+
+	public:
+		PolygonTest();
+		void test();
+	};
+
+}
+
+#endif /* POLYGONTEST_H_ */
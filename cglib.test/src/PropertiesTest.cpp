@@ -0,0 +1,149 @@
+/*
+ * PropertiesTest.cpp
+ */
+
+#include "PropertiesTest.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace cglibtest {
+
+	static const char* TEST_FILE = "properties_test.ini";
+	static const unsigned int LINES = 6000;
+
+	static const char* NUMBERS[] = {
+		"0", "12", "-7", "+5", "00012", " \t 42", "12abc", "1,5", "2147483647", "2147483648", "-2147483649",
+		".5", "5.", "-.5e-2", "1.5e3x", "1e40", "3.4e38", "3.5e38", "1e400", "-1e400",
+		"1e-40", "1e-50", "1e-320", "-1e-320", "1e-400",
+		"0x1A", "0X1p3", "-0x10", "inf", "-inf", "infinity", "nan", "NAN(1)",
+		"", " ", "-", ".", "e5", "1e", "1e+", "1E-2", "x"
+	};
+	static const unsigned int NUMBER_COUNT = sizeof(NUMBERS) / sizeof(NUMBERS[0]);
+
+	// The line parser cg::Properties used before it split files in place
+	static void parseLineWithStreams(const std::string& line, std::map<std::string, std::string>& properties)
+	{
+		std::string name, value, separator;
+		std::istringstream iss(line);
+		if (line.size() > 0) {
+			iss >> name >> separator;
+			if (name[0] == '#')
+				return;
+			value = iss.str().substr(iss.tellg());
+			if (separator == "=") {
+				size_t start = value.find_first_not_of(" ");
+				size_t end = value.find_last_not_of(" ");
+				properties.insert(std::make_pair(name, value.substr(start, end - start + 1)));
+			}
+		}
+	}
+
+	static void readWithStreams(const std::string& filename, std::map<std::string, std::string>& properties)
+	{
+		std::string line;
+		std::ifstream file(filename.c_str());
+		while (!file.eof()) {
+			std::getline(file, line);
+			parseLineWithStreams(line, properties);
+		}
+	}
+
+	PropertiesTest::PropertiesTest() : cg::Test("cg::Properties")
+	{
+	}
+
+	template <class T>
+	void PropertiesTest::checkNumber(const std::string& s)
+	{
+		std::istringstream iss(s);
+		T expected = 0, value = 0;
+		bool is_expected = !(iss >> expected).fail();
+		bool is_parsed = cg::Properties::parse(s, value);
+		if (is_parsed != is_expected || (is_parsed && memcmp(&value, &expected, sizeof(T)) != 0)) {
+			std::cout << "    '" << s << "' as <" << cg::Properties::getTypeName(value) << ">: " << value
+					  << (is_parsed ? "" : " (rejected)") << ", expected " << expected
+					  << (is_expected ? "" : " (rejected)") << std::endl;
+			CHECK(false)
+		}
+	}
+
+	void PropertiesTest::testNumbers()
+	{
+		for (unsigned int i = 0; i < NUMBER_COUNT; i++) {
+			checkNumber<int>(NUMBERS[i]);
+			checkNumber<float>(NUMBERS[i]);
+			checkNumber<double>(NUMBERS[i]);
+		}
+	}
+
+	void PropertiesTest::testVectors()
+	{
+		cg::Vector3d v;
+		CHECK(cg::Properties::parse(" 1.5 -2e1\t.25 rest", v))
+		CHECK(v == cg::Vector3d(1.5, -20, 0.25))
+		CHECK(!cg::Properties::parse("1 2 nan", v))
+		CHECK(!cg::Properties::parse("1 0x2", v))
+		cg::Vector2i w;
+		CHECK(cg::Properties::parse("640 480", w))
+		CHECK(w == cg::Vector2i(640, 480))
+		CHECK(!cg::Properties::parse("640", w))
+	}
+
+	// A generated file with comments, integers, reals, vectors and strings
+	// with blanks around them.
+	void PropertiesTest::testRead()
+	{
+		cg::Random random(19);
+		{
+			std::ofstream file(TEST_FILE);
+			for (unsigned int i = 0; i < LINES; i++) {
+				switch (i % 6) {
+				case 0:
+					file << "# generated line " << i << "\n";
+					break;
+				case 1:
+					file << "LEVEL_COUNT_" << i << " = " << (int)random.between(-100000, 100000) << "\n";
+					break;
+				case 2:
+					file << "  LEVEL_SCALE_" << i << "\t=\t" << random.between(-1000, 1000) << "\n";
+					break;
+				case 3:
+					file << "LEVEL_SIZE_" << i << " = " << random.between(0, 100) << " " << random.between(0, 100) << "\n";
+					break;
+				case 4:
+					file << "LEVEL_NOT_A_PROPERTY_" << i << " : " << i << "\n";
+					break;
+				default:
+					file << "LEVEL_NAME_" << i << " =   entity " << i << "  \n";
+					break;
+				}
+			}
+		}
+		tPropertyMap streams, sliced;
+		readWithStreams(TEST_FILE, streams);
+		cg::Properties::read(TEST_FILE, sliced);
+		std::remove(TEST_FILE);
+		CHECK(sliced.size() == LINES / 6 * 4)
+		CHECK(sliced == streams)
+		unsigned int mismatches = 0;
+		for (tPropertyMap::iterator i = sliced.begin(); i != sliced.end(); i++) {
+			std::istringstream iss(i->second);
+			double expected = 0, value = 0;
+			bool is_expected = !(iss >> expected).fail();
+			if (cg::Properties::parse(i->second, value) != is_expected || value != expected)
+				mismatches++;
+		}
+		CHECK(mismatches == 0)
+	}
+
+	void PropertiesTest::test()
+	{
+		TEST(testNumbers)
+		TEST(testVectors)
+		TEST(testRead)
+	}
+
+}
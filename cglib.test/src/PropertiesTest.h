@@ -0,0 +1,39 @@
+/*
+ * PropertiesTest.h
+ */
+
+#ifndef PROPERTIESTEST_H_
+#define PROPERTIESTEST_H_
+
+#include <map>
+#include <string>
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks cg::Properties against the std::getline and std::istringstream
+	 *  parser it replaced: cg::Properties::read must find the same
+	 *  properties in a generated file, and cg::Properties::parse must
+	 *  accept and reject the same numbers as the extraction operators, with
+	 *  the same values, including hexadecimal, non-finite, underflowing and
+	 *  overflowing ones.
+	 */
+	class PropertiesTest : public cg::Test {
+	private:
+		typedef std::map<std::string, std::string> tPropertyMap;
+
+		template <class T>
+		void checkNumber(const std::string& s);
+
+		void testNumbers();
+		void testVectors();
+		void testRead();
+
+	public:
+		PropertiesTest();
+		void test();
+	};
+
+}
+
+#endif /* PROPERTIESTEST_H_ */
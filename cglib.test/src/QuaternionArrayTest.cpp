@@ -0,0 +1,201 @@
+/*
+ * QuaternionArrayTest.cpp
+ */
+
+#include "QuaternionArrayTest.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cglibtest {
+
+	static const unsigned int LENGTHS[] = { 1, 3, 4, 5, 7, 8, 9, 15, 17, 100 };
+	static const unsigned int LENGTH_COUNT = sizeof(LENGTHS) / sizeof(LENGTHS[0]);
+	static const float SLERP_T[] = { 0.0f, 0.3f, 0.5f, 1.0f };
+	static const unsigned int SLERP_T_COUNT = sizeof(SLERP_T) / sizeof(SLERP_T[0]);
+
+	// Single precision rounding, plus the acos and sin approximations of slerp
+	static const double MULTIPLY_TOLERANCE = 1e-6;
+	static const double SLERP_TOLERANCE = 1e-5;
+	static const double MATRIX_TOLERANCE = 1e-6;
+
+	static cg::Quaterniond toDouble(const cg::Quaternionf& q)
+	{
+		return cg::Quaterniond(q.v[0], q.v[1], q.v[2], q.w);
+	}
+
+	static double maxDifference(const cg::Quaterniond& q, const cg::Quaternionf& r)
+	{
+		double difference = fabs(q.w - r.w);
+		for (int c = 0; c < 3; c++)
+			difference = std::max(difference, fabs(q.v[c] - r.v[c]));
+		return difference;
+	}
+
+	// cg::Quaternion normalize divides by the squared norm, so it only
+	// returns unit quaternions for unit input
+	static cg::Quaternionf unit(const cg::Quaternionf& q)
+	{
+		return q * (1 / sqrtf(norm(q)));
+	}
+
+	// Slerp along the shortest path, as cg::QuaternionArray::slerp does
+	static cg::Quaterniond shortestSlerp(const cg::Quaterniond& q0, const cg::Quaterniond& q1, double t)
+	{
+		cg::Quaterniond q = q1;
+		double d = q0.v[0] * q1.v[0] + q0.v[1] * q1.v[1] + q0.v[2] * q1.v[2] + q0.w * q1.w;
+		if (d < 0) {
+			q = q1 * -1.0;
+			d = -d;
+		}
+		double angle = acos(std::min(d, 1.0));
+		if (sin(angle) < 1e-6)
+			return q0 * (1 - t) + q * t;
+		return (q0 * sin((1 - t) * angle) + q * sin(t * angle)) * (1 / sin(angle));
+	}
+
+	QuaternionArrayTest::QuaternionArrayTest() : cg::Test("cg::QuaternionArray"), _random(19)
+	{
+	}
+
+	void QuaternionArrayTest::fill(unsigned int n)
+	{
+		_a.resize(n);
+		_b.resize(n);
+		for (unsigned int i = 0; i < n; i++) {
+			_a.set(i, unit(cg::Quaternionf(_random.between(-1, 1), _random.between(-1, 1),
+					_random.between(-1, 1), _random.between(-1, 1))));
+			_b.set(i, unit(cg::Quaternionf(_random.between(-1, 1), _random.between(-1, 1),
+					_random.between(-1, 1), _random.between(-1, 1))));
+		}
+	}
+
+	// Runs check on the first elements of _a and _b, for every length and
+	// with every kernel.
+	void QuaternionArrayTest::forEachKernel(void (QuaternionArrayTest::*check)())
+	{
+		cg::QuaternionArray a = _a, b = _b;
+		std::vector<std::string> kernels = cg::QuaternionArray::getKernels();
+		for (unsigned int k = 0; k < kernels.size(); k++) {
+			CHECK(cg::QuaternionArray::setKernel(kernels[k]))
+			for (unsigned int l = 0; l < LENGTH_COUNT; l++) {
+				_a = a;
+				_b = b;
+				_a.resize(LENGTHS[l]);
+				_b.resize(LENGTHS[l]);
+				(this->*check)();
+			}
+		}
+		cg::QuaternionArray::setKernel(kernels.back());
+		_a = a;
+		_b = b;
+	}
+
+	// The comparisons are written so that a NaN fails them.
+	void QuaternionArrayTest::checkMultiply()
+	{
+		cg::QuaternionArray r, in_place = _a;
+		r.multiply(_a, _b);
+		in_place.multiply(in_place, _b);
+		bool within = true, same = true;
+		for (unsigned int i = 0; i < _a.size(); i++) {
+			within = within && maxDifference(toDouble(_a.get(i)) * toDouble(_b.get(i)), r.get(i)) < MULTIPLY_TOLERANCE;
+			same = same && maxDifference(toDouble(r.get(i)), in_place.get(i)) == 0;
+		}
+		CHECK(r.size() == _a.size())
+		CHECK(within)
+		CHECK(same)
+	}
+
+	void QuaternionArrayTest::checkSlerp()
+	{
+		for (unsigned int s = 0; s < SLERP_T_COUNT; s++) {
+			float t = SLERP_T[s];
+			cg::QuaternionArray r;
+			r.slerp(_a, _b, t);
+			bool within = true, unit = true;
+			for (unsigned int i = 0; i < _a.size(); i++) {
+				cg::Quaterniond reference = shortestSlerp(toDouble(_a.get(i)), toDouble(_b.get(i)), t);
+				within = within && maxDifference(reference, r.get(i)) < SLERP_TOLERANCE;
+				unit = unit && fabs(norm(toDouble(r.get(i))) - 1) < SLERP_TOLERANCE;
+			}
+			CHECK(within)
+			CHECK(unit)
+		}
+	}
+
+	void QuaternionArrayTest::checkMatrices()
+	{
+		unsigned int n = _a.size();
+		std::vector<float> matrices(9 * n), gl_matrices(16 * n);
+		_a.getMatrices(&matrices[0]);
+		_a.getGLMatrices(&gl_matrices[0]);
+		bool within = true, gl_within = true;
+		for (unsigned int i = 0; i < n; i++) {
+			cg::Quaterniond q = toDouble(_a.get(i));
+			double reference[16];
+			q.getGLMatrix(reference);
+			for (int k = 0; k < 16; k++)
+				gl_within = gl_within && fabs(reference[k] - gl_matrices[16 * i + k]) < MATRIX_TOLERANCE;
+			for (int c = 0; c < 3; c++)
+				for (int r = 0; r < 3; r++)
+					within = within && fabs(reference[4 * c + r] - matrices[9 * i + 3 * c + r]) < MATRIX_TOLERANCE;
+		}
+		CHECK(within)
+		CHECK(gl_within)
+	}
+
+	void QuaternionArrayTest::testMultiply()
+	{
+		fill(LENGTHS[LENGTH_COUNT - 1]);
+		forEachKernel(&QuaternionArrayTest::checkMultiply);
+	}
+
+	void QuaternionArrayTest::testSlerp()
+	{
+		fill(LENGTHS[LENGTH_COUNT - 1]);
+		forEachKernel(&QuaternionArrayTest::checkSlerp);
+	}
+
+	// Pairs whose angle is below the linear interpolation threshold, or just
+	// above it, including identical pairs.
+	void QuaternionArrayTest::testSlerpNearlyEqual()
+	{
+		fill(LENGTHS[LENGTH_COUNT - 1]);
+		for (unsigned int i = 0; i < _a.size(); i++) {
+			cg::Quaternionf q = _a.get(i);
+			float delta = i % 4 == 0 ? 0 : 1e-4f / (1 << (i % 8));
+			_b.set(i, unit(cg::Quaternionf(q.v[0] + delta, q.v[1] - delta, q.v[2], q.w)));
+		}
+		forEachKernel(&QuaternionArrayTest::checkSlerp);
+	}
+
+	// Pairs close to q and -q, which are the same rotation: the shortest path
+	// interpolates between them without dividing by sin(angle) ~ 0.
+	void QuaternionArrayTest::testSlerpNearlyOpposite()
+	{
+		fill(LENGTHS[LENGTH_COUNT - 1]);
+		for (unsigned int i = 0; i < _a.size(); i++) {
+			cg::Quaternionf q = _a.get(i);
+			float delta = i % 4 == 0 ? 0 : 1e-4f / (1 << (i % 8));
+			_b.set(i, unit(cg::Quaternionf(-q.v[0] + delta, -q.v[1], -q.v[2] - delta, -q.w)));
+		}
+		forEachKernel(&QuaternionArrayTest::checkSlerp);
+	}
+
+	void QuaternionArrayTest::testMatrices()
+	{
+		fill(LENGTHS[LENGTH_COUNT - 1]);
+		forEachKernel(&QuaternionArrayTest::checkMatrices);
+	}
+
+	void QuaternionArrayTest::test()
+	{
+		TEST(testMultiply)
+		TEST(testSlerp)
+		TEST(testSlerpNearlyEqual)
+		TEST(testSlerpNearlyOpposite)
+		TEST(testMatrices)
+	}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * QuaternionArrayTest.h
+ */
+
+#ifndef QUATERNIONARRAYTEST_H_
+#define QUATERNIONARRAYTEST_H_
+
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks cg::QuaternionArray, with every kernel the CPU supports and on
+	 *  lengths that are not multiples of the 4 and 8 lanes, against double
+	 *  precision cg::Quaterniond results: multiply, slerp on random, nearly
+	 *  equal and nearly opposite pairs, and both matrix layouts.
+	 */
+	class QuaternionArrayTest : public cg::Test {
+	private:
+		cg::Random _random;
+		cg::QuaternionArray _a, _b;
+
+		void fill(unsigned int n);
+		void checkMultiply();
+		void checkSlerp();
+		void checkMatrices();
+		void forEachKernel(void (QuaternionArrayTest::*check)());
+
+		void testMultiply();
+		void testSlerp();
+		void testSlerpNearlyEqual();
+		void testSlerpNearlyOpposite();
+		void testMatrices();
+
+	public:
+		QuaternionArrayTest();
+		void test();
+	};
+
+}
+
+#endif /* QUATERNIONARRAYTEST_H_ */
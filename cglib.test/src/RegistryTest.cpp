@@ -0,0 +1,129 @@
+/*
+ * RegistryTest.cpp
+ */
+
+#include "RegistryTest.h"
+
+namespace cglibtest {
+
+	class Thing : public cg::Entity {
+	public:
+		Thing(const std::string& id) : cg::Entity(id) {}
+		void init() {}
+	};
+
+	class Mover : public cg::Entity, public cg::IUpdateListener {
+	public:
+		Mover(const std::string& id) : cg::Entity(id) {}
+		void init() {}
+		void update(unsigned long elapsed_millis) {}
+	};
+
+	RegistryTest::RegistryTest() : cg::Test("cg::Registry")
+	{
+	}
+
+	void RegistryTest::testStaleHandle()
+	{
+		cg::Registry* registry = cg::Registry::instance();
+		unsigned int size = registry->size();
+		Thing* first = new Thing("RegistryTest.first");
+		cg::EntityHandle h1 = registry->add(first);
+		CHECK(!h1.isNull())
+		CHECK(registry->get(h1) == first)
+		CHECK(first->getHandle() == h1)
+		registry->destroy(h1);
+		CHECK(registry->get(h1) == 0)
+		CHECK(!registry->exists(h1))
+		CHECK(!registry->exists("RegistryTest.first"))
+
+		Thing* second = new Thing("RegistryTest.second");
+		cg::EntityHandle h2 = registry->add(second);
+		CHECK(h2.index == h1.index)
+		CHECK(h2.generation == cg::EntityHandle::nextGeneration(h1.generation))
+		CHECK(registry->get(h1) == 0)
+		CHECK(registry->get(h2) == second)
+		CHECK(registry->getHandle("RegistryTest.second") == h2)
+		registry->remove(h2);
+		CHECK(second->getHandle().isNull())
+		CHECK(registry->get(h2) == 0)
+		CHECK(registry->size() == size)
+		delete second;
+	}
+
+	void RegistryTest::testGenerationWrap()
+	{
+		CHECK(cg::EntityHandle::nextGeneration(1) == 2)
+		CHECK(cg::EntityHandle::nextGeneration(0xfffffffeu) == 0xffffffffu)
+		CHECK(cg::EntityHandle::nextGeneration(0xffffffffu) == 1)
+		CHECK(cg::EntityHandle().isNull())
+	}
+
+	void RegistryTest::testUnindexed()
+	{
+		cg::Registry* registry = cg::Registry::instance();
+		unsigned int size = registry->size();
+		Thing* a = new Thing("RegistryTest.same");
+		Thing* b = new Thing("RegistryTest.same");
+		cg::EntityHandle ha = registry->add(a, false);
+		cg::EntityHandle hb = registry->add(b, false);
+		CHECK(ha != hb)
+		CHECK(registry->get(ha) == a)
+		CHECK(registry->get(hb) == b)
+		CHECK(!registry->exists("RegistryTest.same"))
+		CHECK(registry->size() == size + 2)
+
+		// An indexed entity may take the name, and keeps it when they go
+		Thing* c = new Thing("RegistryTest.same");
+		registry->add(c);
+		CHECK(registry->get("RegistryTest.same") == c)
+		registry->destroy(ha);
+		registry->destroy(hb);
+		CHECK(registry->get("RegistryTest.same") == c)
+		registry->destroy("RegistryTest.same");
+		CHECK(registry->size() == size)
+	}
+
+	void RegistryTest::testRejectedListener()
+	{
+		cg::Registry* registry = cg::Registry::instance();
+		cg::UpdateNotifier* notifier = cg::UpdateNotifier::instance();
+		unsigned int size = registry->size();
+		unsigned int listeners = notifier->size();
+		Mover* a = new Mover("RegistryTest.mover");
+		Mover* b = new Mover("RegistryTest.mover");
+		cg::EntityHandle ha = registry->add(a);
+		CHECK(notifier->size() == listeners + 1)
+
+		TEST_EXCEPTION(std::runtime_error, registry->add(b, false))
+		CHECK(registry->size() == size + 1)
+		CHECK(notifier->size() == listeners + 1)
+		CHECK(notifier->get("RegistryTest.mover") == a)
+		CHECK(b->getHandle().isNull())
+
+		notifier->lock();
+		TEST_EXCEPTION(std::runtime_error, registry->add(b, false))
+		notifier->unlock();
+		CHECK(registry->size() == size + 1)
+		CHECK(notifier->get("RegistryTest.mover") == a)
+
+		// Once the first one is gone, the identifier is free again
+		notifier->lock();
+		registry->destroy(ha);
+		cg::EntityHandle hb = registry->add(b, false);
+		notifier->unlock();
+		CHECK(notifier->get("RegistryTest.mover") == b)
+		registry->destroy(hb);
+		CHECK(registry->size() == size)
+		CHECK(notifier->size() == listeners)
+	}
+
+	void RegistryTest::test()
+	{
+		TEST(testStaleHandle)
+		TEST(testGenerationWrap)
+		TEST(testUnindexed)
+		TEST(testRejectedListener)
+	}
+
+}
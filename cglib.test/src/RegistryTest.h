@@ -0,0 +1,32 @@
+/*
+ * RegistryTest.h
+ */
+
+#ifndef REGISTRYTEST_H_
+#define REGISTRYTEST_H_
+
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks the slot table of cg::Registry: handles to removed entities
+	 *  are stale even once their slot is reused, slot generations skip the
+	 *  null generation when they wrap, entities outside the name index may
+	 *  share an identifier, and an add rejected by a notifier, locked or
+	 *  not, leaves neither the registry nor the notifiers changed.
+	 */
+	class RegistryTest : public cg::Test {
+	private:
+		void testStaleHandle();
+		void testGenerationWrap();
+		void testUnindexed();
+		void testRejectedListener();
+
+	public:
+		RegistryTest();
+		void test();
+	};
+
+}
+
+#endif /* REGISTRYTEST_H_ */
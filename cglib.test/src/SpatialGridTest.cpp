@@ -0,0 +1,195 @@
+/*
+ * SpatialGridTest.cpp
+ */
+
+#include "SpatialGridTest.h"
+#include <algorithm>
+
+namespace cglibtest {
+
+	static const double WIDTH = 640, HEIGHT = 480, CELL_SIZE = 16;
+	static const unsigned int BOXES = 300;
+	static const unsigned int FRAMES = 60;
+
+	static bool isBefore(const cg::tCollisionPair& p, const cg::tCollisionPair& q)
+	{
+		return p.a < q.a || (p.a == q.a && p.b < q.b);
+	}
+
+	static bool isSame(const cg::tCollisionPair& p, const cg::tCollisionPair& q)
+	{
+		return p.a == q.a && p.b == q.b;
+	}
+
+	SpatialGridTest::SpatialGridTest() : cg::Test("cg::SpatialGrid"), _random(29)
+	{
+	}
+
+	void SpatialGridTest::place(uint32_t id, float x, float y, float width, float height)
+	{
+		if (id >= _boxes.size()) {
+			tBox inactive = { 0, 0, 0, 0, false };
+			_boxes.resize(id + 1, inactive);
+		}
+		tBox& box = _boxes[id];
+		box.minX = x;
+		box.minY = y;
+		box.maxX = x + width;
+		box.maxY = y + height;
+		box.isActive = true;
+		_grid.update(id, cg::Vector2d(box.minX, box.minY), cg::Vector2d(box.maxX, box.maxY));
+	}
+
+	// The pairs must be those of the brute force search, each once with a < b.
+	bool SpatialGridTest::isMatchingPairs()
+	{
+		cg::Util* util = cg::Util::instance();
+		std::vector<cg::tCollisionPair> expected, pairs;
+		for (uint32_t a = 0; a < _boxes.size(); a++) {
+			for (uint32_t b = a + 1; b < _boxes.size(); b++) {
+				const tBox& p = _boxes[a];
+				const tBox& q = _boxes[b];
+				if (p.isActive && q.isActive
+						&& util->isAABBoxCollision(cg::Vector2d(p.minX, p.minY), cg::Vector2d(p.maxX, p.maxY),
+								cg::Vector2d(q.minX, q.minY), cg::Vector2d(q.maxX, q.maxY))) {
+					cg::tCollisionPair pair = { a, b };
+					expected.push_back(pair);
+				}
+			}
+		}
+		_grid.findPairs(pairs);
+		for (unsigned int i = 0; i < pairs.size(); i++) {
+			if (pairs[i].a >= pairs[i].b)
+				return false;
+		}
+		std::sort(pairs.begin(), pairs.end(), isBefore);
+		return pairs.size() == expected.size() && std::equal(pairs.begin(), pairs.end(), expected.begin(), isSame);
+	}
+
+	bool SpatialGridTest::isMatchingQuery(float min_x, float min_y, float max_x, float max_y)
+	{
+		cg::Util* util = cg::Util::instance();
+		std::vector<uint32_t> expected, ids;
+		for (uint32_t id = 0; id < _boxes.size(); id++) {
+			const tBox& box = _boxes[id];
+			if (box.isActive
+					&& util->isAABBoxCollision(cg::Vector2d(min_x, min_y), cg::Vector2d(max_x, max_y),
+							cg::Vector2d(box.minX, box.minY), cg::Vector2d(box.maxX, box.maxY)))
+				expected.push_back(id);
+		}
+		_grid.query(cg::Vector2d(min_x, min_y), cg::Vector2d(max_x, max_y), ids);
+		std::sort(ids.begin(), ids.end());
+		return ids == expected;
+	}
+
+	// Mostly small boxes, one in ten spanning many cells, moving fast enough
+	// to cross cell boundaries every few frames and to leave the grid.
+	void SpatialGridTest::testMovingBoxes()
+	{
+		_grid.clear();
+		_grid.setup(WIDTH, HEIGHT, CELL_SIZE);
+		_boxes.clear();
+		std::vector<float> vx(BOXES), vy(BOXES), w(BOXES), h(BOXES);
+		for (uint32_t id = 0; id < BOXES; id++) {
+			bool is_large = (id % 10 == 0);
+			w[id] = (float)_random.between(1, is_large ? 8 * CELL_SIZE : CELL_SIZE / 2);
+			h[id] = (float)_random.between(1, is_large ? 8 * CELL_SIZE : CELL_SIZE / 2);
+			vx[id] = (float)_random.between(-6, 6);
+			vy[id] = (float)_random.between(-6, 6);
+			place(id, (float)_random.between(-20, WIDTH), (float)_random.between(-20, HEIGHT), w[id], h[id]);
+		}
+		bool pairs = true, queries = true;
+		for (unsigned int f = 0; f < FRAMES; f++) {
+			for (uint32_t id = 0; id < BOXES; id++) {
+				float x = _boxes[id].minX + vx[id], y = _boxes[id].minY + vy[id];
+				if (x < -30 || x > WIDTH + 10)
+					vx[id] = -vx[id];
+				if (y < -30 || y > HEIGHT + 10)
+					vy[id] = -vy[id];
+				place(id, x, y, w[id], h[id]);
+			}
+			pairs = pairs && isMatchingPairs();
+			float x = (float)_random.between(-50, WIDTH), y = (float)_random.between(-50, HEIGHT);
+			queries = queries && isMatchingQuery(x, y, x + (float)_random.between(0, 200), y + (float)_random.between(0, 200));
+		}
+		CHECK(pairs)
+		CHECK(queries)
+	}
+
+	void SpatialGridTest::testRemoval()
+	{
+		_grid.clear();
+		_grid.setup(WIDTH, HEIGHT, CELL_SIZE);
+		_boxes.clear();
+		for (uint32_t id = 0; id < BOXES; id++)
+			place(id, (float)_random.between(0, WIDTH), (float)_random.between(0, HEIGHT),
+					(float)_random.between(1, 3 * CELL_SIZE), (float)_random.between(1, 3 * CELL_SIZE));
+		bool pairs = true;
+		for (unsigned int round = 0; round < 10; round++) {
+			for (unsigned int r = 0; r < BOXES / 10; r++) {
+				uint32_t id = (uint32_t)_random.between(0, BOXES);
+				_grid.remove(id);
+				_boxes[id].isActive = false;
+			}
+			pairs = pairs && isMatchingPairs();
+			for (unsigned int a = 0; a < BOXES / 20; a++) {
+				uint32_t id = (uint32_t)_random.between(0, BOXES + 20);
+				place(id, (float)_random.between(0, WIDTH), (float)_random.between(0, HEIGHT),
+						(float)_random.between(1, 3 * CELL_SIZE), (float)_random.between(1, 3 * CELL_SIZE));
+			}
+			pairs = pairs && isMatchingPairs();
+		}
+		CHECK(pairs)
+		for (uint32_t id = 0; id < _boxes.size(); id++) {
+			_grid.remove(id);
+			_boxes[id].isActive = false;
+		}
+		std::vector<cg::tCollisionPair> none;
+		_grid.findPairs(none);
+		CHECK(none.empty())
+	}
+
+	// A triangle in the lower left half of its box only collides with the
+	// boxes reaching that half.
+	void SpatialGridTest::testPolygons()
+	{
+		_grid.clear();
+		_grid.setup(WIDTH, HEIGHT, CELL_SIZE);
+		std::vector<cg::Vector2d> triangle;
+		triangle.push_back(cg::Vector2d(100, 100));
+		triangle.push_back(cg::Vector2d(200, 100));
+		triangle.push_back(cg::Vector2d(100, 200));
+		_grid.update(0, cg::Vector2d(100, 100), cg::Vector2d(200, 200));
+		_grid.setPolygon(0, &triangle);
+		_grid.update(1, cg::Vector2d(180, 180), cg::Vector2d(190, 190));	// corner of the box only
+		_grid.update(2, cg::Vector2d(120, 120), cg::Vector2d(130, 130));	// inside the triangle
+		_grid.update(3, cg::Vector2d(190, 95), cg::Vector2d(210, 105));	// across an edge
+		_grid.update(4, cg::Vector2d(20, 20), cg::Vector2d(500, 400));	// around it
+		std::vector<cg::tCollisionPair> pairs;
+		_grid.findPairs(pairs);
+		std::vector<uint32_t> hits;
+		for (unsigned int i = 0; i < pairs.size(); i++) {
+			if (pairs[i].a == 0)
+				hits.push_back(pairs[i].b);
+		}
+		std::sort(hits.begin(), hits.end());
+		uint32_t expected[] = { 2, 3, 4 };
+		CHECK(hits == std::vector<uint32_t>(expected, expected + 3))
+		_grid.setPolygon(0, 0);
+		_grid.findPairs(pairs);
+		hits.clear();
+		for (unsigned int i = 0; i < pairs.size(); i++) {
+			if (pairs[i].a == 0)
+				hits.push_back(pairs[i].b);
+		}
+		CHECK(hits.size() == 4)
+	}
+
+	void SpatialGridTest::test()
+	{
+		TEST(testMovingBoxes)
+		TEST(testRemoval)
+		TEST(testPolygons)
+	}
+
+}
@@ -0,0 +1,45 @@
+/*
+ * SpatialGridTest.h
+ */
+
+#ifndef SPATIALGRIDTEST_H_
+#define SPATIALGRIDTEST_H_
+
+#include <vector>
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks the pairs found by cg::SpatialGrid::findPairs, and the ids
+	 *  found by cg::SpatialGrid::query, against a brute force search over
+	 *  the same boxes: boxes moving across cell boundaries and out of the
+	 *  grid with incremental updates, boxes spanning many cells, removed
+	 *  and re-added boxes, and boxes narrowed by a polygon.
+	 */
+	class SpatialGridTest : public cg::Test {
+	private:
+		typedef struct {
+			float minX, minY, maxX, maxY;
+			bool isActive;
+		} tBox;
+
+		cg::Random _random;
+		cg::SpatialGrid _grid;
+		std::vector<tBox> _boxes;
+
+		void place(uint32_t id, float x, float y, float width, float height);
+		bool isMatchingPairs();
+		bool isMatchingQuery(float min_x, float min_y, float max_x, float max_y);
+
+		void testMovingBoxes();
+		void testRemoval();
+		void testPolygons();
+
+	public:
+		SpatialGridTest();
+		void test();
+	};
+
+}
+
+#endif /* SPATIALGRIDTEST_H_ */
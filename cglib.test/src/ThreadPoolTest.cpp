@@ -0,0 +1,101 @@
+/*
+ * ThreadPoolTest.cpp
+ */
+
+#include "ThreadPoolTest.h"
+#include <cstring>
+
+namespace cglibtest {
+
+	static const unsigned int COUNTS[] = { 1, 63, 64, 65, 1000, 10007 };
+	static const unsigned int COUNT_COUNT = sizeof(COUNTS) / sizeof(COUNTS[0]);
+	static const unsigned int GRAINS[] = { 1, 64, 5000 };
+	static const unsigned int GRAIN_COUNT = sizeof(GRAINS) / sizeof(GRAINS[0]);
+	static const unsigned int THREADS[] = { 1, 2, 3, 8 };
+	static const unsigned int THREAD_COUNT = sizeof(THREADS) / sizeof(THREADS[0]);
+
+	ThreadPoolTest::ThreadPoolTest() : cg::Test("cg::ThreadPool"), _grain(1)
+	{
+		cg::Random random(31);
+		_input.resize(COUNTS[COUNT_COUNT - 1]);
+		random.fill(&_input[0], _input.size(), -1000, 1000);
+	}
+
+	// Each element gets the running float sum of its chunk so far, and each
+	// chunk its total, so any change of boundaries changes the result.
+	void ThreadPoolTest::run(unsigned int begin, unsigned int end)
+	{
+		float sum = 0;
+		for (unsigned int i = begin; i < end; i++) {
+			sum += _input[i];
+			_output[i] = sum;
+		}
+		_sums[begin / _grain] = sum;
+	}
+
+	std::vector<float> ThreadPoolTest::runTask(unsigned int count, unsigned int grain)
+	{
+		_grain = grain;
+		_output.assign(count, 0);
+		_sums.assign((count + grain - 1) / grain, 0);
+		cg::ThreadPool::instance()->run(this, count, grain);
+		std::vector<float> result(_output);
+		result.insert(result.end(), _sums.begin(), _sums.end());
+		return result;
+	}
+
+	void ThreadPoolTest::testThreadCounts()
+	{
+		cg::ThreadPool* pool = cg::ThreadPool::instance();
+		std::vector<std::vector<float> > expected;
+		pool->stop();
+		CHECK(pool->getThreadCount() == 1)
+		for (unsigned int c = 0; c < COUNT_COUNT; c++) {
+			for (unsigned int g = 0; g < GRAIN_COUNT; g++)
+				expected.push_back(runTask(COUNTS[c], GRAINS[g]));
+		}
+		for (unsigned int t = 0; t < THREAD_COUNT; t++) {
+			pool->start(THREADS[t]);
+			CHECK(pool->getThreadCount() == THREADS[t])
+			bool same = true;
+			for (unsigned int c = 0, k = 0; c < COUNT_COUNT; c++) {
+				for (unsigned int g = 0; g < GRAIN_COUNT; g++, k++) {
+					std::vector<float> result = runTask(COUNTS[c], GRAINS[g]);
+					same = same && result.size() == expected[k].size()
+							&& memcmp(&result[0], &expected[k][0], result.size() * sizeof(float)) == 0;
+				}
+			}
+			CHECK(same)
+		}
+		pool->stop();
+	}
+
+	// Workers started by a restart must wait for the next run, not check in
+	// for runs that happened before they existed.
+	void ThreadPoolTest::testRestart()
+	{
+		cg::ThreadPool* pool = cg::ThreadPool::instance();
+		pool->stop();
+		std::vector<float> expected = runTask(1000, 16);
+		bool same = true;
+		for (unsigned int cycle = 0; cycle < 30; cycle++) {
+			pool->start(2 + cycle % 3);
+			for (unsigned int r = 0; r < 10; r++) {
+				std::vector<float> result = runTask(1000, 16);
+				same = same && memcmp(&result[0], &expected[0], result.size() * sizeof(float)) == 0;
+			}
+			if (cycle % 5 == 4)
+				pool->stop();
+		}
+		pool->stop();
+		CHECK(same)
+		CHECK(pool->getThreadCount() == 1)
+	}
+
+	void ThreadPoolTest::test()
+	{
+		TEST(testThreadCounts)
+		TEST(testRestart)
+	}
+
+}
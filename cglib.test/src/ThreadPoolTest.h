@@ -0,0 +1,38 @@
+/*
+ * ThreadPoolTest.h
+ */
+
+#ifndef THREADPOOLTEST_H_
+#define THREADPOOLTEST_H_
+
+#include <vector>
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks that cg::ThreadPool::run gives bitwise the same result
+	 *  serially and with 2 and more threads, for a task whose result
+	 *  depends on the chunk boundaries (a float sum per chunk), on ranges
+	 *  that leave a partial last chunk; and that the pool keeps working
+	 *  across repeated start and stop cycles.
+	 */
+	class ThreadPoolTest : public cg::Test, public cg::IParallelTask {
+	private:
+		std::vector<float> _input, _output;
+		std::vector<float> _sums;
+		unsigned int _grain;
+
+		std::vector<float> runTask(unsigned int count, unsigned int grain);
+
+		void testThreadCounts();
+		void testRestart();
+
+	public:
+		ThreadPoolTest();
+		void test();
+		void run(unsigned int begin, unsigned int end);
+	};
+
+}
+
+#endif /* THREADPOOLTEST_H_ */
@@ -0,0 +1,117 @@
+/*
+ * UtilTest.cpp
+ */
+
+#include "UtilTest.h"
+
+namespace cglibtest {
+
+	static const unsigned int LENGTHS[] = { 0, 1, 7, 31, 32, 33, 63, 64, 65, 95, 100 };
+	static const unsigned int LENGTH_COUNT = sizeof(LENGTHS) / sizeof(LENGTHS[0]);
+
+	UtilTest::UtilTest() : cg::Test("cg::Util")
+	{
+	}
+
+	void UtilTest::addBox(float min_x, float min_y, float max_x, float max_y)
+	{
+		_minX.push_back(min_x);
+		_minY.push_back(min_y);
+		_maxX.push_back(max_x);
+		_maxY.push_back(max_y);
+	}
+
+	// Tests one box against the first n boxes, with every supported kernel.
+	// The hit words are filled with ones first, so that bits left set past
+	// the last box, or words left unwritten, are caught.
+	void UtilTest::checkBatch(float min_x, float min_y, float max_x, float max_y, unsigned int n)
+	{
+		cg::Util* util = cg::Util::instance();
+		cg::Vector2d bl(min_x, min_y), tr(max_x, max_y);
+		std::vector<std::string> kernels = util->getAABBoxKernels();
+		for (unsigned int k = 0; k < kernels.size(); k++) {
+			CHECK(util->setAABBoxKernel(kernels[k]))
+			std::vector<uint32_t> hits((n + 31) / 32 + 1, 0xffffffffu);
+			unsigned int count = util->isAABBoxCollision(min_x, min_y, max_x, max_y,
+					&_minX[0], &_minY[0], &_maxX[0], &_maxY[0], n, &hits[0]);
+			unsigned int expected = 0;
+			bool match = true;
+			for (unsigned int i = 0; i < n; i++) {
+				bool hit = util->isAABBoxCollision(bl, tr, cg::Vector2d(_minX[i], _minY[i]), cg::Vector2d(_maxX[i], _maxY[i]));
+				if (hit)
+					expected++;
+				if (hit != (((hits[i / 32] >> (i % 32)) & 1) != 0))
+					match = false;
+			}
+			CHECK(match)
+			CHECK(count == expected)
+			if (n % 32 != 0)
+				CHECK((hits[n / 32] >> (n % 32)) == 0)
+			CHECK(hits[(n + 31) / 32] == 0xffffffffu)
+		}
+		util->setAABBoxKernel(kernels.back());
+	}
+
+	// Repeats the eight boxes of the set up to the longest length, and tests
+	// each of them against the others, for each length.
+	void UtilTest::checkAll()
+	{
+		for (unsigned int i = 8; i < LENGTHS[LENGTH_COUNT - 1]; i++)
+			addBox(_minX[i % 8], _minY[i % 8], _maxX[i % 8], _maxY[i % 8]);
+		for (unsigned int l = 0; l < LENGTH_COUNT; l++)
+			for (unsigned int i = 0; i < 8; i++)
+				checkBatch(_minX[i], _minY[i], _maxX[i], _maxY[i], LENGTHS[l]);
+	}
+
+	// Boxes sharing an edge or a corner with [0,1]x[0,1], and boxes just apart.
+	void UtilTest::testTouchingBoxes()
+	{
+		_minX.clear(); _minY.clear(); _maxX.clear(); _maxY.clear();
+		addBox(0, 0, 1, 1);
+		addBox(1, 0, 2, 1);
+		addBox(-1, 1, 0, 2);
+		addBox(1, 1, 2, 2);
+		addBox(0, -1, 1, 0);
+		addBox(1.0001f, 0, 2, 1);
+		addBox(-1, -1, -0.0001f, 0);
+		addBox(0.5f, 1.0001f, 0.75f, 3);
+		checkAll();
+	}
+
+	// Points and segments, on the edges of [0,1]x[0,1], inside and outside it.
+	void UtilTest::testDegenerateBoxes()
+	{
+		_minX.clear(); _minY.clear(); _maxX.clear(); _maxY.clear();
+		addBox(0, 0, 1, 1);
+		addBox(1, 1, 1, 1);
+		addBox(0.5f, 0.5f, 0.5f, 0.5f);
+		addBox(0, 2, 0, 2);
+		addBox(1, -1, 1, 2);
+		addBox(-1, 0.5f, 2, 0.5f);
+		addBox(2, 0, 3, 0);
+		addBox(0, 0, 0, 0);
+		checkAll();
+	}
+
+	// Boxes on a coarse grid, so that many of them share edges.
+	void UtilTest::testRandomBoxes()
+	{
+		cg::Random random(7);
+		_minX.clear(); _minY.clear(); _maxX.clear(); _maxY.clear();
+		for (unsigned int i = 0; i < LENGTHS[LENGTH_COUNT - 1]; i++) {
+			float x = (float)(random.next() % 16), y = (float)(random.next() % 16);
+			addBox(x, y, x + (float)(random.next() % 4), y + (float)(random.next() % 4));
+		}
+		for (unsigned int l = 0; l < LENGTH_COUNT; l++)
+			for (unsigned int i = 0; i < LENGTHS[LENGTH_COUNT - 1]; i++)
+				checkBatch(_minX[i], _minY[i], _maxX[i], _maxY[i], LENGTHS[l]);
+	}
+
+	void UtilTest::test()
+	{
+		TEST(testTouchingBoxes)
+		TEST(testDegenerateBoxes)
+		TEST(testRandomBoxes)
+	}
+
+}
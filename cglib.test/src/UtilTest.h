@@ -0,0 +1,37 @@
+/*
+ * UtilTest.h
+ */
+
+#ifndef UTILTEST_H_
+#define UTILTEST_H_
+
+#include <vector>
+#include "cg/cg.h"
+
+namespace cglibtest {
+
+	/** Checks the batch cg::Util::isAABBoxCollision against the scalar
+	 *  cg::Vector2d version, with every kernel the CPU supports: touching
+	 *  and shared edge boxes, degenerate (zero width or height) boxes, and
+	 *  lengths that leave a partial last word in the hit mask.
+	 */
+	class UtilTest : public cg::Test {
+	private:
+		std::vector<float> _minX, _minY, _maxX, _maxY;
+
+		void addBox(float min_x, float min_y, float max_x, float max_y);
+		void checkBatch(float min_x, float min_y, float max_x, float max_y, unsigned int n);
+		void checkAll();
+
+		void testTouchingBoxes();
+		void testDegenerateBoxes();
+		void testRandomBoxes();
+
+	public:
+		UtilTest();
+		void test();
+	};
+
+}
+
+#endif /* UTILTEST_H_ */
@@ -0,0 +1,32 @@
+/*
+ * main.cpp
+ */
+
+#include "cg/cg.h"
+#include "AlignedVectorTest.h"
+#include "ComponentStoreTest.h"
+#include "LockableOrderedMapTest.h"
+#include "PolygonTest.h"
+#include "PropertiesTest.h"
+#include "QuaternionArrayTest.h"
+#include "RegistryTest.h"
+#include "SpatialGridTest.h"
+#include "ThreadPoolTest.h"
+#include "UtilTest.h"
+
+int main(int argc, char** argv)
+{
+	cg::TestSuite suite("cglib");
+	suite.addTest(new cglibtest::AlignedVectorTest());
+	suite.addTest(new cglibtest::ComponentStoreTest());
+	suite.addTest(new cglibtest::LockableOrderedMapTest());
+	suite.addTest(new cglibtest::PolygonTest());
+	suite.addTest(new cglibtest::PropertiesTest());
+	suite.addTest(new cglibtest::QuaternionArrayTest());
+	suite.addTest(new cglibtest::RegistryTest());
+	suite.addTest(new cglibtest::SpatialGridTest());
+	suite.addTest(new cglibtest::ThreadPoolTest());
+	suite.addTest(new cglibtest::UtilTest());
+	suite.run();
+	return cg::Test::getFailureCount() == 0 ? 0 : 1;
+}
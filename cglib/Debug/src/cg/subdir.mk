@@ -5,6 +5,7 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../src/cg/Application.cpp \
+../src/cg/ComponentStore.cpp \
 ../src/cg/DebugFile.cpp \
 ../src/cg/DebugNotifier.cpp \
 ../src/cg/DrawNotifier.cpp \
@@ -13,15 +14,26 @@ CPP_SRCS += \
 ../src/cg/KeyBuffer.cpp \
 ../src/cg/KeyboardEventNotifier.cpp \
 ../src/cg/Manager.cpp \
+../src/cg/Metrics.cpp \
+../src/cg/MetricsOverlay.cpp \
 ../src/cg/MouseEventNotifier.cpp \
+../src/cg/Polygon.cpp \
+../src/cg/Profiler.cpp \
+../src/cg/ProfilerOverlay.cpp \
 ../src/cg/Properties.cpp \
+../src/cg/QuaternionArray.cpp \
+../src/cg/Random.cpp \
 ../src/cg/Registry.cpp \
 ../src/cg/ReshapeEventNotifier.cpp \
+../src/cg/SpatialGrid.cpp \
+../src/cg/ThreadPool.cpp \
+../src/cg/Tracer.cpp \
 ../src/cg/UpdateNotifier.cpp \
 ../src/cg/Util.cpp 
 
 OBJS += \
 ./src/cg/Application.o \
+./src/cg/ComponentStore.o \
 ./src/cg/DebugFile.o \
 ./src/cg/DebugNotifier.o \
 ./src/cg/DrawNotifier.o \
@@ -30,15 +42,26 @@ OBJS += \
 ./src/cg/KeyBuffer.o \
 ./src/cg/KeyboardEventNotifier.o \
 ./src/cg/Manager.o \
+./src/cg/Metrics.o \
+./src/cg/MetricsOverlay.o \
 ./src/cg/MouseEventNotifier.o \
+./src/cg/Polygon.o \
+./src/cg/Profiler.o \
+./src/cg/ProfilerOverlay.o \
 ./src/cg/Properties.o \
+./src/cg/QuaternionArray.o \
+./src/cg/Random.o \
 ./src/cg/Registry.o \
 ./src/cg/ReshapeEventNotifier.o \
+./src/cg/SpatialGrid.o \
+./src/cg/ThreadPool.o \
+./src/cg/Tracer.o \
 ./src/cg/UpdateNotifier.o \
 ./src/cg/Util.o 
 
 CPP_DEPS += \
 ./src/cg/Application.d \
+./src/cg/ComponentStore.d \
 ./src/cg/DebugFile.d \
 ./src/cg/DebugNotifier.d \
 ./src/cg/DrawNotifier.d \
@@ -47,10 +70,20 @@ CPP_DEPS += \
 ./src/cg/KeyBuffer.d \
 ./src/cg/KeyboardEventNotifier.d \
 ./src/cg/Manager.d \
+./src/cg/Metrics.d \
+./src/cg/MetricsOverlay.d \
 ./src/cg/MouseEventNotifier.d \
+./src/cg/Polygon.d \
+./src/cg/Profiler.d \
+./src/cg/ProfilerOverlay.d \
 ./src/cg/Properties.d \
+./src/cg/QuaternionArray.d \
+./src/cg/Random.d \
 ./src/cg/Registry.d \
 ./src/cg/ReshapeEventNotifier.d \
+./src/cg/SpatialGrid.d \
+./src/cg/ThreadPool.d \
+./src/cg/Tracer.d \
 ./src/cg/UpdateNotifier.d \
 ./src/cg/Util.d 
 
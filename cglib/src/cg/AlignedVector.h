@@ -0,0 +1,275 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef ALIGNED_VECTOR_H
+#define ALIGNED_VECTOR_H
+
+#include "Vector.h"
+
+#if defined(CG_SIMD) && defined(__SSE2__)
+#include <immintrin.h>
+#define CG_SIMD_SSE2
+#if defined(__AVX__)
+#define CG_SIMD_AVX
+#endif
+#endif
+
+namespace cg {
+
+	/** Lane-wise kernels used by cg::AlignedVector, for L lanes of type T.
+	 *  The generic version loops over the lanes; when cglib is compiled with
+	 *  CG_SIMD defined, float x4 and double x2 use SSE, and double x4 uses AVX
+	 *  (or two SSE halves if the compiler does not target AVX). AVX uses
+	 *  unaligned loads, since heap blocks (e.g. std::vector storage) are only
+	 *  guaranteed to be 16-byte aligned.
+	 *  Every kernel performs the same IEEE operations, lane by lane, as the
+	 *  cg::Vector operators, so results are bit-identical.
+	 */
+	template <class T, int L>
+	struct AlignedLanes {
+		static void add(T* r, const T* a, const T* b) { for(int i = 0; i < L; i++) r[i] = a[i] + b[i]; }
+		static void sub(T* r, const T* a, const T* b) { for(int i = 0; i < L; i++) r[i] = a[i] - b[i]; }
+		static void mul(T* r, const T* a, const T* b) { for(int i = 0; i < L; i++) r[i] = a[i] * b[i]; }
+		static void div(T* r, const T* a, const T* b) { for(int i = 0; i < L; i++) r[i] = a[i] / b[i]; }
+		static void mul(T* r, const T* a, T k) { for(int i = 0; i < L; i++) r[i] = a[i] * k; }
+		static void div(T* r, const T* a, T k) { for(int i = 0; i < L; i++) r[i] = a[i] / k; }
+		static void neg(T* r, const T* a) { for(int i = 0; i < L; i++) r[i] = -a[i]; }
+		static void cross(T* r, const T* a, const T* b) {
+			T x = a[1] * b[2] - a[2] * b[1];
+			T y = a[2] * b[0] - a[0] * b[2];
+			T z = a[0] * b[1] - a[1] * b[0];
+			r[0] = x;
+			r[1] = y;
+			r[2] = z;
+			r[3] = 0;
+		}
+		static const char* getISA() { return "generic"; }
+	};
+
+#ifdef CG_SIMD_SSE2
+	template <>
+	struct AlignedLanes<float,4> {
+		static void add(float* r, const float* a, const float* b) { _mm_store_ps(r, _mm_add_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+		static void sub(float* r, const float* a, const float* b) { _mm_store_ps(r, _mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+		static void mul(float* r, const float* a, const float* b) { _mm_store_ps(r, _mm_mul_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+		static void div(float* r, const float* a, const float* b) { _mm_store_ps(r, _mm_div_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+		static void mul(float* r, const float* a, float k) { _mm_store_ps(r, _mm_mul_ps(_mm_load_ps(a), _mm_set1_ps(k))); }
+		static void div(float* r, const float* a, float k) { _mm_store_ps(r, _mm_div_ps(_mm_load_ps(a), _mm_set1_ps(k))); }
+		static void neg(float* r, const float* a) { _mm_store_ps(r, _mm_xor_ps(_mm_load_ps(a), _mm_set1_ps(-0.0f))); }
+		static void cross(float* r, const float* a, const float* b) {
+			// (y z x w) * (z x y w) - (z x y w) * (y z x w)
+			__m128 va = _mm_load_ps(a), vb = _mm_load_ps(b);
+			__m128 a1 = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+			__m128 b1 = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+			__m128 a2 = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 1, 0, 2));
+			__m128 b2 = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 1, 0, 2));
+			_mm_store_ps(r, _mm_sub_ps(_mm_mul_ps(a1, b2), _mm_mul_ps(a2, b1)));
+		}
+		static const char* getISA() { return "SSE2"; }
+	};
+
+	template <>
+	struct AlignedLanes<double,2> {
+		static void add(double* r, const double* a, const double* b) { _mm_store_pd(r, _mm_add_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+		static void sub(double* r, const double* a, const double* b) { _mm_store_pd(r, _mm_sub_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+		static void mul(double* r, const double* a, const double* b) { _mm_store_pd(r, _mm_mul_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+		static void div(double* r, const double* a, const double* b) { _mm_store_pd(r, _mm_div_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+		static void mul(double* r, const double* a, double k) { _mm_store_pd(r, _mm_mul_pd(_mm_load_pd(a), _mm_set1_pd(k))); }
+		static void div(double* r, const double* a, double k) { _mm_store_pd(r, _mm_div_pd(_mm_load_pd(a), _mm_set1_pd(k))); }
+		static void neg(double* r, const double* a) { _mm_store_pd(r, _mm_xor_pd(_mm_load_pd(a), _mm_set1_pd(-0.0))); }
+		static const char* getISA() { return "SSE2"; }
+	};
+
+	template <>
+	struct AlignedLanes<double,4> {
+#ifdef CG_SIMD_AVX
+		static void add(double* r, const double* a, const double* b) { _mm256_storeu_pd(r, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b))); }
+		static void sub(double* r, const double* a, const double* b) { _mm256_storeu_pd(r, _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b))); }
+		static void mul(double* r, const double* a, const double* b) { _mm256_storeu_pd(r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b))); }
+		static void div(double* r, const double* a, const double* b) { _mm256_storeu_pd(r, _mm256_div_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b))); }
+		static void mul(double* r, const double* a, double k) { _mm256_storeu_pd(r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_set1_pd(k))); }
+		static void div(double* r, const double* a, double k) { _mm256_storeu_pd(r, _mm256_div_pd(_mm256_loadu_pd(a), _mm256_set1_pd(k))); }
+		static void neg(double* r, const double* a) { _mm256_storeu_pd(r, _mm256_xor_pd(_mm256_loadu_pd(a), _mm256_set1_pd(-0.0))); }
+		static const char* getISA() { return "AVX"; }
+#else
+		static void add(double* r, const double* a, const double* b) { AlignedLanes<double,2>::add(r, a, b); AlignedLanes<double,2>::add(r + 2, a + 2, b + 2); }
+		static void sub(double* r, const double* a, const double* b) { AlignedLanes<double,2>::sub(r, a, b); AlignedLanes<double,2>::sub(r + 2, a + 2, b + 2); }
+		static void mul(double* r, const double* a, const double* b) { AlignedLanes<double,2>::mul(r, a, b); AlignedLanes<double,2>::mul(r + 2, a + 2, b + 2); }
+		static void div(double* r, const double* a, const double* b) { AlignedLanes<double,2>::div(r, a, b); AlignedLanes<double,2>::div(r + 2, a + 2, b + 2); }
+		static void mul(double* r, const double* a, double k) { AlignedLanes<double,2>::mul(r, a, k); AlignedLanes<double,2>::mul(r + 2, a + 2, k); }
+		static void div(double* r, const double* a, double k) { AlignedLanes<double,2>::div(r, a, k); AlignedLanes<double,2>::div(r + 2, a + 2, k); }
+		static void neg(double* r, const double* a) { AlignedLanes<double,2>::neg(r, a); AlignedLanes<double,2>::neg(r + 2, a + 2); }
+		static const char* getISA() { return "SSE2"; }
+#endif
+		static void cross(double* r, const double* a, const double* b) {
+			// (y z x) * (z x y) - (z x y) * (y z x), on two SSE halves
+			__m128d axy = _mm_load_pd(a), azw = _mm_load_pd(a + 2);
+			__m128d bxy = _mm_load_pd(b), bzw = _mm_load_pd(b + 2);
+			__m128d ayz = _mm_shuffle_pd(axy, azw, 1), byz = _mm_shuffle_pd(bxy, bzw, 1);
+			__m128d azx = _mm_unpacklo_pd(azw, axy), bzx = _mm_unpacklo_pd(bzw, bxy);
+			_mm_store_pd(r, _mm_sub_pd(_mm_mul_pd(ayz, bzx), _mm_mul_pd(azx, byz)));
+			__m128d x = _mm_sub_sd(_mm_mul_sd(axy, _mm_unpackhi_pd(bxy, bxy)), _mm_mul_sd(_mm_unpackhi_pd(axy, axy), bxy));
+			_mm_store_pd(r + 2, _mm_move_sd(_mm_setzero_pd(), x));
+		}
+	};
+#endif
+
+	template <class T, int D> struct AlignedVectorOf;
+	template <class T> struct AlignedVectorOf<T,2> { typedef Vector2<T> type; enum { LANES = 2 }; };
+	template <class T> struct AlignedVectorOf<T,3> { typedef Vector3<T> type; enum { LANES = 4 }; };
+
+	/** cg::AlignedVector is a D-dimensional vector stored in a power of two
+	 *  number of lanes, aligned to its size, so that the arithmetic can be
+	 *  done in single SIMD instructions (see cg::AlignedLanes):
+	 *    cg::Vector2da - 2D vector of double precision, 2 lanes.
+	 *    cg::Vector3fa - 3D vector of single precision, 4 lanes.
+	 *    cg::Vector3da - 3D vector of double precision, 4 lanes.
+	 *  The extra lane of 3D vectors is zero after construction and holds
+	 *  no meaningful value after arithmetic. Results match the corresponding
+	 *  cg::Vector2d, cg::Vector3f and cg::Vector3d operations bit for bit,
+	 *  as long as the compiler does not contract multiply-adds (FMA) in the
+	 *  generic code. Sums (dot, length) are done lane by lane in cg::Vector's
+	 *  order, and only the products are vectorized.
+	 */
+	template <class T, int D>
+	class AlignedVector {
+
+	public:
+		typedef typename AlignedVectorOf<T,D>::type tVector;
+		enum { LANES = AlignedVectorOf<T,D>::LANES };
+		typedef AlignedLanes<T,LANES> tLanes;
+
+		T data[LANES] __attribute__((aligned(sizeof(T) * LANES)));
+
+		AlignedVector() { for(int i = 0; i < LANES; i++) data[i] = 0; }
+		AlignedVector(const T k) {
+			for(int i = 0; i < LANES; i++) data[i] = i < D ? k : 0;
+		}
+		AlignedVector(const T x, const T y) {
+			data[0] = x;
+			data[1] = y;
+			for(int i = 2; i < LANES; i++) data[i] = 0;
+		}
+		AlignedVector(const T x, const T y, const T z) {
+			data[0] = x;
+			data[1] = y;
+			data[2] = z;
+			for(int i = 3; i < LANES; i++) data[i] = 0;
+		}
+		AlignedVector(const tVector& v) {
+			for(int i = 0; i < LANES; i++) data[i] = i < D ? v.data[i] : 0;
+		}
+
+		tVector toVector() const { return tVector(data); }
+		const T& operator[](int i) const {
+			assert(i<D);
+			return data[i];
+		}
+		T& operator[](int i) {
+			assert(i<D);
+			return data[i];
+		}
+		T* get() { return &data[0]; }
+		const T* get() const { return &data[0]; }
+
+		//---<comparison>---
+
+		bool operator==(const AlignedVector& v) const {
+			for(int i = 0; i < D; i++) if(data[i] != v.data[i]) return false;
+			return true;
+		}
+		bool operator!=(const AlignedVector& v) const { return !(*this == v); }
+
+		//---<assignment>---
+
+		void operator*=(T k) { tLanes::mul(data, data, k); }
+		void operator/=(T k) { tLanes::div(data, data, k); }
+		void operator*=(const AlignedVector& v) { tLanes::mul(data, data, v.data); }
+		void operator/=(const AlignedVector& v) { tLanes::div(data, data, v.data); }
+		void operator+=(const AlignedVector& v) { tLanes::add(data, data, v.data); }
+		void operator-=(const AlignedVector& v) { tLanes::sub(data, data, v.data); }
+
+		//---<unary>---
+
+		const AlignedVector operator-() const { AlignedVector r; tLanes::neg(r.data, data); return r; }
+
+		//---<binary>---
+
+		const AlignedVector operator+(const AlignedVector& v) const { AlignedVector r; tLanes::add(r.data, data, v.data); return r; }
+		const AlignedVector operator-(const AlignedVector& v) const { AlignedVector r; tLanes::sub(r.data, data, v.data); return r; }
+		const AlignedVector operator*(const AlignedVector& v) const { AlignedVector r; tLanes::mul(r.data, data, v.data); return r; }
+		const AlignedVector operator*(const T k) const { AlignedVector r; tLanes::mul(r.data, data, k); return r; }
+		const AlignedVector operator/(const AlignedVector& v) const { AlignedVector r; tLanes::div(r.data, data, v.data); return r; }
+		const AlignedVector operator/(const T k) const { AlignedVector r; tLanes::div(r.data, data, k); return r; }
+
+		//---<stream>---
+
+		friend inline std::ostream& operator<<(std::ostream& os, const AlignedVector& v) {
+			os << "( ";
+			for(int i = 0; i < D; i++) os << v.data[i] << " ";
+			os << ")";
+			return os;
+		}
+
+		//---<generic.math>---
+
+		friend const T squaredLength(const AlignedVector& v) {
+			AlignedVector p;
+			tLanes::mul(p.data, v.data, v.data);
+			T result = 0;
+			for(int i = 0; i < D; i++) result += p.data[i];
+			return result;
+		}
+		friend const double length(const AlignedVector& v) {
+			AlignedVector p;
+			tLanes::mul(p.data, v.data, v.data);
+			double result = 0;
+			for(int i = 0; i < D; i++) result += p.data[i];
+			return sqrt(result);
+		}
+		friend const AlignedVector normalize(const AlignedVector& v) {
+			AlignedVector r;
+			double d = length(v);
+			if(d != 0.0) {
+				tLanes::div(r.data, v.data, (T)d);
+			}
+			return r;
+		}
+		friend const T dot(const AlignedVector& v1, const AlignedVector& v2) {
+			AlignedVector p;
+			tLanes::mul(p.data, v1.data, v2.data);
+			T result = 0;
+			for(int i = 0; i < D; i++) result += p.data[i];
+			return result;
+		}
+	};
+
+	template <class T>
+	inline const AlignedVector<T,3> cross(const AlignedVector<T,3>& v1, const AlignedVector<T,3>& v2) {
+		AlignedVector<T,3> r;
+		AlignedLanes<T,4>::cross(r.data, v1.data, v2.data);
+		return r;
+	}
+
+	//---<predefined>---
+
+	typedef AlignedVector<double,2> Vector2da;
+	typedef AlignedVector<float,3> Vector3fa;
+	typedef AlignedVector<double,3> Vector3da;
+}
+
+#endif // ALIGNED_VECTOR_H
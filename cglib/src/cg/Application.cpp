@@ -27,6 +27,21 @@ namespace cg {
 		setup();
 		try {
 			cg::Properties::instance()->load(property_file);
+			// LOG_LEVEL = DEBUG, INFO, WARNING or ERROR
+			if(cg::Properties::instance()->exists("LOG_LEVEL")) {
+				DebugFile::instance()->setLevel(DebugFile::parseLevel(cg::Properties::instance()->getString("LOG_LEVEL")));
+			}
+			// PROPERTIES_RELOAD = 1 reloads the file between frames whenever it is saved
+			if(cg::Properties::instance()->exists("PROPERTIES_RELOAD") && cg::Properties::instance()->getInt("PROPERTIES_RELOAD") > 0) {
+				cg::Properties::instance()->watch();
+			}
+			// TRACE = 1 records a trace, written to TRACE_FILE (trace.json) on shutdown
+			if(cg::Properties::instance()->exists("TRACE") && cg::Properties::instance()->getInt("TRACE") > 0) {
+				Tracer::instance()->setTracingEntities(cg::Properties::instance()->exists("TRACE_ENTITIES") &&
+					cg::Properties::instance()->getInt("TRACE_ENTITIES") > 0);
+				Tracer::instance()->start(cg::Properties::instance()->exists("TRACE_CAPACITY") ?
+					cg::Properties::instance()->getInt("TRACE_CAPACITY") : Tracer::DEFAULT_CAPACITY);
+			}
 		} catch(std::runtime_error& e) {
 			DebugFile::instance()->writeException(e);
 			throw e;
@@ -37,6 +52,15 @@ namespace cg {
         _time.last = 0;
         _time.current = 0;
         _time.elapsed = 0;
+        _time.lastNanos = 0;
+        _time.currentNanos = 0;
+        _time.elapsedNanos = 0;
+        _time.elapsedSeconds = 0;
+        _time.alpha = 1.0;
+        _fixedStep.enabled = false;
+        _fixedStep.step = 0;
+        _fixedStep.maxSubsteps = 0;
+        _fixedStep.accumulatorNanos = 0;
         _window.caption = "OpenGL GLUT Application";
         _window.x = 100;
         _window.y = 100;
@@ -44,6 +68,8 @@ namespace cg {
         _window.height = 480;
         _window.display_mode = GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH;
 		_isFirstUpdate = true;
+		_isHeadless = false;
+		_frameMillis = 0;
 	}
     Application::~Application() {
     }
@@ -53,10 +79,34 @@ namespace cg {
     const tTime& Application::getTime() const {
         return _time;
     }
+    void Application::setFixedTimeStep(unsigned long step_millis, unsigned int max_substeps) {
+        if(step_millis == 0 || max_substeps == 0) {
+            throw std::runtime_error("[cg::Application] fixed time step and substeps must be positive.");
+        }
+        _fixedStep.enabled = true;
+        _fixedStep.step = step_millis;
+        _fixedStep.maxSubsteps = max_substeps;
+        _fixedStep.accumulatorNanos = 0;
+    }
+    void Application::setVariableTimeStep() {
+        _fixedStep.enabled = false;
+        _time.alpha = 1.0;
+    }
     void Application::onInit() {
-        glShadeModel(GL_SMOOTH);
+        if(!_isHeadless) {
+            glShadeModel(GL_SMOOTH);
+        }
 		try {
 			createEntities();
+#ifdef CG_PROFILE
+			if(!_isHeadless) {
+				addEntity(new ProfilerOverlay());
+			}
+#endif
+			if(!_isHeadless && Properties::instance()->exists("METRICS_OVERLAY") &&
+				Properties::instance()->getInt("METRICS_OVERLAY") > 0) {
+				addEntity(new MetricsOverlay());
+			}
 		} catch(std::runtime_error& e) {
 			DebugFile::instance()->writeException(e);
 			throw e;
@@ -65,19 +115,40 @@ namespace cg {
     }
     inline
     void Application::updateFrameTime() {
-        ftime(&_timeb);
+		_time.lastNanos = _time.currentNanos;
+		_time.currentNanos = Clock::nanoseconds();
+		_time.elapsedNanos = _time.currentNanos - _time.lastNanos;
+		_time.elapsedSeconds = _time.elapsedNanos * 1e-9;
 		_time.last = _time.current;
-		_time.current = (_timeb.time * 1000) + _timeb.millitm;
+		_time.current = (unsigned long)(_time.currentNanos / 1000000);
 		_time.elapsed = _time.current - _time.last;
     }
     void Application::onUpdate() {
         updateFrameTime();
 		if(_isFirstUpdate) {
 			_isFirstUpdate = false;
+			_frameMillis = Metrics::instance()->getHistogram("frame.ms", 0, 100, 200);
 			return;
 		}
+		_frameMillis->add(_time.elapsedNanos * 1e-6);
+		Properties::instance()->poll();
 		DebugNotifier::instance()->debug();
-		UpdateNotifier::instance()->update(_time.elapsed);
+		if(_fixedStep.enabled) {
+			uint64_t step_nanos = (uint64_t)_fixedStep.step * 1000000;
+			_fixedStep.accumulatorNanos += _time.elapsedNanos;
+			unsigned int substeps = 0;
+			while(_fixedStep.accumulatorNanos >= step_nanos && substeps < _fixedStep.maxSubsteps) {
+				UpdateNotifier::instance()->update(_fixedStep.step);
+				_fixedStep.accumulatorNanos -= step_nanos;
+				substeps++;
+			}
+			// too far behind: drop whole steps rather than spiral into ever longer frames
+			_fixedStep.accumulatorNanos %= step_nanos;
+			_time.alpha = (double)_fixedStep.accumulatorNanos / (double)step_nanos;
+		} else {
+			UpdateNotifier::instance()->update(_time.elapsed);
+		}
+		Metrics::instance()->aggregate();
     }
 	inline
 	void Application::setOverlayProjection() {
@@ -106,12 +177,30 @@ namespace cg {
         _window.width = w;
         _window.height = h;
     }
-	void Application::addEntity(Entity *entity) {
+	EntityHandle Application::addEntity(Entity *entity, bool is_indexed) {
 		if(entity != 0) {
-			Registry::instance()->add(entity);
+			return Registry::instance()->add(entity, is_indexed);
 		}
+		return EntityHandle();
 	}
 	void Application::shutdown() {
+		if(Tracer::instance()->isRecording()) {
+			try {
+				Tracer::instance()->writeChromeTrace(Properties::instance()->exists("TRACE_FILE") ?
+					Properties::instance()->getString("TRACE_FILE") : std::string("trace.json"));
+			} catch(std::runtime_error& e) {
+				DebugFile::instance()->writeException(e);
+			}
+		}
+		// METRICS_CSV = 1 writes the last metrics snapshot to METRICS_FILE (metrics.csv)
+		if(Properties::instance()->exists("METRICS_CSV") && Properties::instance()->getInt("METRICS_CSV") > 0) {
+			try {
+				Metrics::instance()->writeCsv(Properties::instance()->exists("METRICS_FILE") ?
+					Properties::instance()->getString("METRICS_FILE") : std::string("metrics.csv"));
+			} catch(std::runtime_error& e) {
+				DebugFile::instance()->writeException(e);
+			}
+		}
 		KeyboardEventNotifier::instance()->cleanup();
 		MouseEventNotifier::instance()->cleanup();
 		ReshapeEventNotifier::instance()->cleanup();
@@ -120,11 +209,21 @@ namespace cg {
 		DrawOverlayNotifier::instance()->cleanup();
 		DebugNotifier::instance()->cleanup();
 		Registry::instance()->cleanup();
+		Metrics::instance()->cleanup();
+		ThreadPool::instance()->cleanup();
+		Profiler::instance()->cleanup();
+		Tracer::instance()->cleanup();
 		DebugFile::instance()->cleanup();
 		KeyBuffer::instance()->cleanup();
 		Properties::instance()->cleanup();
 		Util::instance()->cleanup();
 	}
+	void Application::setHeadless(bool is_headless) {
+		_isHeadless = is_headless;
+	}
+	bool Application::isHeadless() const {
+		return _isHeadless;
+	}
 	void Application::dump() const {
 		Registry::instance()->dump();
 		DebugFile::instance()->writeLine("[Notifiers]");
@@ -135,6 +234,9 @@ namespace cg {
 		MouseEventNotifier::instance()->dump();
 		ReshapeEventNotifier::instance()->dump();
 		DebugNotifier::instance()->dump();
+#ifdef CG_PROFILE
+		Profiler::instance()->dump();
+#endif
 		DebugFile::instance()->newLine();
 	}
 }
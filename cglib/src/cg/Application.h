@@ -20,9 +20,10 @@
 #define APPLICATION_H
 
 #include <string>
-#include <sys/timeb.h>
+#include <stdint.h>
 #include <GL/glut.h>
 #include <stdexcept>
+#include "Clock.h"
 #include "DebugFile.h"
 #include "DebugNotifier.h"
 #include "DrawNotifier.h"
@@ -30,10 +31,16 @@
 #include "Entity.h"
 #include "KeyBuffer.h"
 #include "KeyboardEventNotifier.h"
+#include "Metrics.h"
+#include "MetricsOverlay.h"
 #include "MouseEventNotifier.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
 #include "Properties.h"
 #include "Registry.h"
 #include "ReshapeEventNotifier.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
 #include "UpdateNotifier.h"
 #include "Util.h"
 
@@ -45,10 +52,26 @@ namespace cg {
         int display_mode;
     } tWindow;
 
+    /** Frame times. last, current and elapsed are in milliseconds; the *Nanos
+     *  fields hold the same instants at cg::Clock resolution, and
+     *  elapsedSeconds is elapsedNanos in seconds. current is the truncation
+     *  of currentNanos, so the sum of the elapsed milliseconds never drifts
+     *  from the real elapsed time by more than one millisecond.
+     */
     typedef struct {
         unsigned long last, current, elapsed;
+        uint64_t lastNanos, currentNanos, elapsedNanos;
+        double elapsedSeconds;
+        double alpha;
     } tTime;
 
+    typedef struct {
+        bool enabled;
+        unsigned long step;
+        unsigned int maxSubsteps;
+        uint64_t accumulatorNanos;
+    } tFixedStep;
+
 	/** cg::Application is an abstract class controlling the initialization,
 	 *  update and display cycle of the application.
 	 *  To create an application, just create a subclass of cg::Application and
@@ -65,6 +88,14 @@ namespace cg {
 	 *  cg::Application::display.
 	 *  These methods can be redefined in the subclass if a finer control of
 	 *  the simulation cycle is needed.
+	 *  By default, the update step receives the real time elapsed since the
+	 *  previous frame. After cg::Application::setFixedTimeStep, time is instead
+	 *  accumulated and the update step is run once per elapsed fixed step (at
+	 *  most maxSubsteps times per frame, dropping the excess), so that the
+	 *  simulation does not depend on the frame rate. The fraction of a step
+	 *  left in the accumulator is available to the draw step as
+	 *  cg::tTime::alpha, to interpolate between the last two simulated states.
+	 *  Without a fixed step, alpha is always 1.
 	 */
     class Application {
 
@@ -72,12 +103,15 @@ namespace cg {
         tWindow _window;
 
         tTime _time;
-        struct timeb _timeb;
         void updateFrameTime();
 
+        tFixedStep _fixedStep;
+
 		bool _isFirstUpdate;
+		bool _isHeadless;
+		Histogram* _frameMillis;
 		void setup();
-		void addEntity(Entity* entity);
+		EntityHandle addEntity(Entity* entity, bool is_indexed = true);
 		virtual void setOverlayProjection();
 
     public:
@@ -87,12 +121,16 @@ namespace cg {
 
         const tWindow& getWindow() const;
         const tTime& getTime() const;
+        void setFixedTimeStep(unsigned long step_millis, unsigned int max_substeps = 5);
+        void setVariableTimeStep();
 
         virtual void onInit();
         virtual void onUpdate();
         virtual void onDisplay();
         void onReshape(int w, int h);
 		void shutdown();
+		void setHeadless(bool is_headless);
+		bool isHeadless() const;
 
         virtual void createEntities() = 0;
 		void dump() const;
@@ -0,0 +1,50 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+namespace cg {
+
+	/** cg::Clock reads a monotonic, high-resolution clock (CLOCK_MONOTONIC).
+	 *  Its values count from an arbitrary point in the past and are only
+	 *  meaningful as differences; unlike wall-clock time they never jump
+	 *  backwards when the system time is adjusted.
+	 */
+	class Clock {
+	public:
+		static uint64_t nanoseconds();
+		static unsigned long milliseconds();
+		static double seconds();
+	};
+
+	inline uint64_t Clock::nanoseconds() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+	inline unsigned long Clock::milliseconds() {
+		return (unsigned long)(nanoseconds() / 1000000);
+	}
+	inline double Clock::seconds() {
+		return nanoseconds() * 1e-9;
+	}
+}
+
+#endif // CLOCK_H
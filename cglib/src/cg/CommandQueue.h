@@ -16,11 +16,14 @@
 //
 // Copyright 2007 Carlos Martinho
 
+
 #ifndef COMMAND_QUEUE_H
 #define COMMAND_QUEUE_H
 
+#include <map>
+#include <set>
 #include <string>
-#include <queue>
+#include <vector>
 #include <stdexcept>
 #include "LockableOrderedMap.h"
 
@@ -31,147 +34,149 @@ namespace cg {
 
 	//---<CommandQueue>---
 
+	/** cg::Command<T> is a deferred cg::LockableOrderedMap<T> operation,
+	 *  stored by value: the type of the operation, the identifier it applies
+	 *  to (empty for the 'All' operations) and the element to add.
+	 */
 	template <class T>
-	class Command {
-	public:
-		Command() {}
-		virtual ~Command() {}
-		virtual void execute(LockableOrderedMap<T>* activity_map) = 0;
+	struct Command {
+		typedef enum { ADD, REMOVE, REMOVE_ALL, DESTROY, DESTROY_ALL } tType;
+		tType type;
+		std::string id;
+		T* element;
 	};
 
+	/** cg::CommandQueue<T> buffers the operations requested on a locked
+	 *  cg::LockableOrderedMap<T> and applies them, in order, in a single pass
+	 *  when the map is unlocked. The commands, and the strings holding their
+	 *  identifiers, are kept from one lock to the next and only overwritten,
+	 *  so that queuing a command does not allocate once the buffer has grown
+	 *  to the number of commands of a typical frame.
+	 *  The queue also tracks the net effect of its commands on the names of
+	 *  the map: the elements added and not removed since, and the names
+	 *  removed, so that cg::LockableOrderedMap<T> can reject an existing
+	 *  identifier when it is added rather than when the commands are applied.
+	 */
 	template <class T>
 	class CommandQueue {
 	private:
-		std::queue<Command<T>*> _commands;
+		std::vector<Command<T> > _commands;
+		unsigned int _size;
 		std::map<const std::string,T*> _newElements;
-        typedef typename std::map<const std::string,T*>::iterator newElementItr;
+		typedef typename std::map<const std::string,T*>::const_iterator tNewElementIterator;
+		std::set<std::string> _removedNames;
+		bool _isAllRemoved;
+
+		Command<T>& push(typename Command<T>::tType type);
+		void clear();
 
 	public:
-		CommandQueue() {}
-		~CommandQueue() { destroy(); }
-		void add(Command<T>* command);
-		void addElement(std::string id, T* element);
-		bool existsElement(const std::string& id);
-		T* getElement(const std::string& id);
-		void execute(LockableOrderedMap<T>* activity_map);
+		CommandQueue() : _size(0), _isAllRemoved(false) {}
+		~CommandQueue() {}
+		void add(typename Command<T>::tType type, const std::string& id, T* element);
+		void add(typename Command<T>::tType type);
+		bool existsElement(const std::string& id) const;
+		T* getElement(const std::string& id) const;
+		bool isRemoved(const std::string& id) const;
+		void execute(LockableOrderedMap<T>* lomap);
 		void destroy();
 	};
+	// Reuses the next command of the buffer, growing it only when full.
 	template <class T>
-	void CommandQueue<T>::add(Command<T>* command) {
-		_commands.push(command);
+	Command<T>& CommandQueue<T>::push(typename Command<T>::tType type) {
+		if(_size == _commands.size()) {
+			_commands.resize(_size + 1);
+		}
+		Command<T>& command = _commands[_size++];
+		command.type = type;
+		return command;
+	}
+	template <class T>
+	void CommandQueue<T>::clear() {
+		_size = 0;
+		_newElements.clear();
+		_removedNames.clear();
+		_isAllRemoved = false;
 	}
 	template <class T>
-	void CommandQueue<T>::addElement(std::string id, T* element) {
-		std::pair<newElementItr,bool> result = _newElements.insert( std::make_pair(id,element) );
-		if(result.second == false) {
-			throw std::invalid_argument("[cg::CommandQueue] element '" + id + "' already exists.");
+	void CommandQueue<T>::add(typename Command<T>::tType type, const std::string& id, T* element) {
+		Command<T>& command = push(type);
+		command.id.assign(id);
+		command.element = element;
+		if(type == Command<T>::ADD) {
+			_newElements[id] = element;
+		} else {
+			_newElements.erase(id);
+			_removedNames.insert(id);
 		}
 	}
 	template <class T>
-	bool CommandQueue<T>::existsElement(const std::string& id) {
-		return (_newElements.count(id) != 0);
+	void CommandQueue<T>::add(typename Command<T>::tType type) {
+		Command<T>& command = push(type);
+		command.id.clear();
+		command.element = 0;
+		_newElements.clear();
+		_removedNames.clear();
+		_isAllRemoved = true;
+	}
+	template <class T>
+	bool CommandQueue<T>::existsElement(const std::string& id) const {
+		return _newElements.count(id) != 0;
 	}
 	template <class T>
-	T* CommandQueue<T>::getElement(const std::string& id) {
-		newElementItr i = _newElements.find(id);
+	T* CommandQueue<T>::getElement(const std::string& id) const {
+		tNewElementIterator i = _newElements.find(id);
 		if(i == _newElements.end()) {
 			return 0;
 		}
 		return i->second;
 	}
+	// Whether an element the map held when locked is removed by the queue.
+	template <class T>
+	bool CommandQueue<T>::isRemoved(const std::string& id) const {
+		return _isAllRemoved || _removedNames.count(id) != 0;
+	}
+	// Every command is applied even if one fails, and the first failure is
+	// thrown once the queue is empty.
 	template <class T>
 	void CommandQueue<T>::execute(LockableOrderedMap<T>* lomap) {
-		while(_commands.empty() == false) {
-			Command<T>* c = _commands.front();
-			c->execute(lomap);
-			_commands.pop();
-			delete c;
+		std::string error;
+		for(unsigned int i = 0; i < _size; i++) {
+			Command<T>& command = _commands[i];
+			try {
+				switch(command.type) {
+				case Command<T>::ADD:
+					lomap->add(command.id, command.element);
+					break;
+				case Command<T>::REMOVE:
+					lomap->remove(command.id);
+					break;
+				case Command<T>::REMOVE_ALL:
+					lomap->removeAll();
+					break;
+				case Command<T>::DESTROY:
+					lomap->destroy(command.id);
+					break;
+				case Command<T>::DESTROY_ALL:
+					lomap->destroyAll();
+					break;
+				}
+			} catch(std::exception& e) {
+				if(error.empty()) {
+					error = e.what();
+				}
+			}
+		}
+		clear();
+		if(!error.empty()) {
+			throw std::runtime_error(error);
 		}
-		_newElements.clear();
 	}
 	template <class T>
 	void CommandQueue<T>::destroy() {
-		while(_commands.empty() == false) {
-			Command<T>* c = _commands.front();
-			_commands.pop();
-			delete c;
-		}
-		_newElements.clear();
+		clear();
 	}
 
-	//---<Commands>---
-
-	template <class T>
-	class AddCommand : public Command<T> {
-	private:
-		std::string _id;
-		T* _element;
-	public:
-		AddCommand(std::string id, T* element) {
-			_id = id;
-			_element = element;
-		}
-		~AddCommand() {
-		}
-		void execute(LockableOrderedMap<T>* lomap) {
-			lomap->add(_id,_element);
-		}
-	};
-
-	template <class T>
-	class RemoveCommand : public Command<T> {
-	private:
-		std::string _id;
-	public:
-		RemoveCommand(std::string id) {
-			_id = id;
-		}
-		~RemoveCommand() {
-		}
-		void execute(LockableOrderedMap<T>* lomap) {
-			lomap->remove(_id);
-		}
-	};
-
-	template <class T>
-	class RemoveAllCommand : public Command<T> {
-	public:
-		RemoveAllCommand() {
-		}
-		~RemoveAllCommand() {
-		}
-		void execute(LockableOrderedMap<T>* lomap) {
-			lomap->removeAll();
-		}
-	};
-
-	template <class T>
-	class DestroyCommand : public Command<T> {
-	private:
-		std::string _id;
-	public:
-		DestroyCommand(std::string id) {
-			_id = id;
-		}
-		~DestroyCommand() {
-		}
-		void execute(LockableOrderedMap<T>* lomap) {
-			lomap->destroy(_id);
-		}
-	};
-
-	template <class T>
-	class DestroyAllCommand : public Command<T> {
-	public:
-		DestroyAllCommand() {
-		}
-		~DestroyAllCommand() {
-		}
-		void execute(LockableOrderedMap<T>* lomap) {
-			lomap->destroyAll();
-		}
-	};
-
 }
 
 #endif
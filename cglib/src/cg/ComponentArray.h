@@ -0,0 +1,111 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef COMPONENT_ARRAY_H
+#define COMPONENT_ARRAY_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace cg {
+
+	/** cg::IComponentArray is the type independent part of a
+	 *  cg::ComponentArray<T>, used by cg::ComponentStore to remove all the
+	 *  components of a destroyed entity.
+	 */
+	class IComponentArray {
+	public:
+		virtual bool has(uint32_t entity) const = 0;
+		virtual void remove(uint32_t entity) = 0;
+
+		virtual ~IComponentArray() {}
+	};
+
+	/** cg::ComponentArray<T> stores the components of type T of the entities
+	 *  of a cg::ComponentStore in a dense array, in no particular order, with
+	 *  the index of the owning entity next to each one. A sparse array maps
+	 *  entity indices to dense slots, so that add, get and remove are
+	 *  constant time; remove moves the last component into the freed slot.
+	 *  Systems should iterate the dense array, from 0 to size().
+	 */
+	template<class T>
+	class ComponentArray : public IComponentArray {
+	public:
+		static const uint32_t NONE = 0xffffffff;
+
+	private:
+		std::vector<T> _components;
+		std::vector<uint32_t> _entities;
+		std::vector<uint32_t> _slots;
+
+	public:
+		ComponentArray() {}
+		~ComponentArray() {}
+
+		unsigned int size() const {
+			return (unsigned int)_components.size();
+		}
+		T& at(unsigned int slot) {
+			return _components[slot];
+		}
+		uint32_t entityAt(unsigned int slot) const {
+			return _entities[slot];
+		}
+		bool has(uint32_t entity) const {
+			return entity < _slots.size() && _slots[entity] != NONE;
+		}
+		T* get(uint32_t entity) {
+			if(has(entity)) {
+				return &_components[_slots[entity]];
+			}
+			return 0;
+		}
+		T& add(uint32_t entity, const T& component) {
+			if(has(entity)) {
+				_components[_slots[entity]] = component;
+				return _components[_slots[entity]];
+			}
+			if(entity >= _slots.size()) {
+				_slots.resize(entity + 1, NONE);
+			}
+			_slots[entity] = (uint32_t)_components.size();
+			_components.push_back(component);
+			_entities.push_back(entity);
+			return _components.back();
+		}
+		void remove(uint32_t entity) {
+			if(!has(entity)) {
+				return;
+			}
+			uint32_t slot = _slots[entity];
+			uint32_t last = (uint32_t)_components.size() - 1;
+			if(slot != last) {
+				_components[slot] = _components[last];
+				_entities[slot] = _entities[last];
+				_slots[_entities[slot]] = slot;
+			}
+			_components.pop_back();
+			_entities.pop_back();
+			_slots[entity] = NONE;
+		}
+	};
+
+	template<class T>
+	const uint32_t ComponentArray<T>::NONE;
+}
+
+#endif // COMPONENT_ARRAY_H
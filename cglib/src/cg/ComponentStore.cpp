@@ -0,0 +1,125 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "ComponentStore.h"
+#ifdef CG_PROFILE
+#include "Clock.h"
+#endif
+
+namespace cg {
+
+	unsigned int ComponentStore::_componentTypes = 0;
+
+	ComponentStore::ComponentStore(const std::string& id) : Entity(id) {
+		_size = 0;
+	}
+	ComponentStore::~ComponentStore() {
+		for(std::vector<ComponentSystem*>::iterator i = _systems.begin(); i != _systems.end(); i++) {
+			delete (*i);
+		}
+		for(std::vector<IComponentArray*>::iterator i = _arrays.begin(); i != _arrays.end(); i++) {
+			delete (*i);
+		}
+	}
+	void ComponentStore::addSystem(ComponentSystem* system) {
+		_systems.push_back(system);
+#ifdef CG_PROFILE
+		_updateProfiles.push_back(Profiler::instance()->getSeries("update", _id + "/" + system->getName()));
+		_drawProfiles.push_back(Profiler::instance()->getSeries("draw", _id + "/" + system->getName()));
+#endif
+	}
+	ComponentId ComponentStore::create() {
+		uint32_t index;
+		if(_freeIndices.empty()) {
+			index = (uint32_t)_generations.size();
+			_generations.push_back(1);
+		} else {
+			index = _freeIndices.back();
+			_freeIndices.pop_back();
+		}
+		_size++;
+		return ComponentId(index, _generations[index]);
+	}
+	void ComponentStore::destroy(const ComponentId& id) {
+		if(!isAlive(id)) {
+			return;
+		}
+		for(std::vector<IComponentArray*>::iterator i = _arrays.begin(); i != _arrays.end(); i++) {
+			if(*i) {
+				(*i)->remove(id.index);
+			}
+		}
+		_generations[id.index] = EntityHandle::nextGeneration(_generations[id.index]);
+		_freeIndices.push_back(id.index);
+		_size--;
+	}
+	void ComponentStore::destroyLater(const ComponentId& id) {
+		_pending.push_back(id);
+	}
+	inline
+	void ComponentStore::destroyPending() {
+		for(unsigned int i = 0; i < _pending.size(); i++) {
+			destroy(_pending[i]);
+		}
+		_pending.clear();
+	}
+	bool ComponentStore::isAlive(const ComponentId& id) const {
+		return id.index < _generations.size() && _generations[id.index] == id.generation;
+	}
+	unsigned int ComponentStore::size() const {
+		return _size;
+	}
+	// The id of the live entity at index, as found in a cg::ComponentArray.
+	ComponentId ComponentStore::getId(uint32_t index) const {
+		return ComponentId(index, _generations[index]);
+	}
+	void ComponentStore::init() {
+		for(std::vector<ComponentSystem*>::iterator i = _systems.begin(); i != _systems.end(); i++) {
+			(*i)->init(*this);
+		}
+	}
+	void ComponentStore::update(unsigned long elapsed_millis) {
+		for(unsigned int i = 0; i < _systems.size(); i++) {
+#ifdef CG_PROFILE
+			uint64_t start = Clock::nanoseconds();
+			_systems[i]->update(*this, elapsed_millis);
+			_updateProfiles[i]->add(Clock::nanoseconds() - start);
+#else
+			_systems[i]->update(*this, elapsed_millis);
+#endif
+		}
+		destroyPending();
+	}
+	void ComponentStore::draw() {
+		for(unsigned int i = 0; i < _systems.size(); i++) {
+#ifdef CG_PROFILE
+			uint64_t start = Clock::nanoseconds();
+			_systems[i]->draw(*this);
+			_drawProfiles[i]->add(Clock::nanoseconds() - start);
+#else
+			_systems[i]->draw(*this);
+#endif
+		}
+		destroyPending();
+	}
+	void ComponentStore::drawOverlay() {
+		for(std::vector<ComponentSystem*>::iterator i = _systems.begin(); i != _systems.end(); i++) {
+			(*i)->drawOverlay(*this);
+		}
+		destroyPending();
+	}
+}
@@ -0,0 +1,142 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef COMPONENT_STORE_H
+#define COMPONENT_STORE_H
+
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ComponentArray.h"
+#include "ComponentSystem.h"
+#include "Entity.h"
+#include "IDrawListener.h"
+#include "IDrawOverlayListener.h"
+#include "IUpdateListener.h"
+#include "Profiler.h"
+
+namespace cg {
+
+	/** cg::ComponentId identifies an entity of a cg::ComponentStore by
+	 *  index and generation, like cg::EntityHandle does in the cg::Registry.
+	 *  The default id (generation 0) is the null id.
+	 */
+	struct ComponentId {
+		uint32_t index;
+		uint32_t generation;
+
+		ComponentId() : index(0), generation(0) {}
+		ComponentId(uint32_t i, uint32_t g) : index(i), generation(g) {}
+		bool isNull() const { return generation == 0; }
+		bool operator==(const ComponentId& id) const {
+			return index == id.index && generation == id.generation;
+		}
+		bool operator!=(const ComponentId& id) const {
+			return !(*this == id);
+		}
+	};
+
+	/** cg::ComponentStore is a data oriented alternative to cg::Entity
+	 *  subclasses, for large numbers of simple objects. Its entities are only
+	 *  ids, to which components of any copyable type T are attached; the
+	 *  components of each type are kept in a dense cg::ComponentArray<T>.
+	 *  Behaviour lives in cg::ComponentSystem's, which the store owns and
+	 *  calls in order during the update, draw and drawOverlay steps.
+	 *  The store itself is a single cg::Entity, registered once in the
+	 *  notifiers, so it can be added to an application next to the classic
+	 *  entities.
+	 *  Destroying an entity moves components around in the arrays: inside a
+	 *  system, use cg::ComponentStore::destroyLater, which defers the
+	 *  destruction to the end of the current step.
+	 */
+	class ComponentStore : public Entity,
+		public IUpdateListener,
+		public IDrawListener,
+		public IDrawOverlayListener {
+
+	private:
+		std::vector<uint32_t> _generations;
+		std::vector<uint32_t> _freeIndices;
+		unsigned int _size;
+		std::vector<IComponentArray*> _arrays;
+		std::vector<ComponentSystem*> _systems;
+		std::vector<ComponentId> _pending;
+		std::vector<ProfileSeries*> _updateProfiles;
+		std::vector<ProfileSeries*> _drawProfiles;
+
+		static unsigned int _componentTypes;
+		template<class T>
+		static unsigned int componentType() {
+			static unsigned int type = _componentTypes++;
+			return type;
+		}
+		void destroyPending();
+
+	public:
+		ComponentStore(const std::string& id);
+		virtual ~ComponentStore();
+
+		void addSystem(ComponentSystem* system);
+		ComponentId create();
+		void destroy(const ComponentId& id);
+		void destroyLater(const ComponentId& id);
+		bool isAlive(const ComponentId& id) const;
+		unsigned int size() const;
+
+		template<class T>
+		ComponentArray<T>& getComponents() {
+			unsigned int type = componentType<T>();
+			if(type >= _arrays.size()) {
+				_arrays.resize(type + 1, 0);
+			}
+			if(_arrays[type] == 0) {
+				_arrays[type] = new ComponentArray<T>();
+			}
+			return *static_cast<ComponentArray<T>*>(_arrays[type]);
+		}
+		template<class T>
+		T& addComponent(const ComponentId& id, const T& component) {
+			if(!isAlive(id)) {
+				throw std::runtime_error("[cg::ComponentStore] cannot add a component to a dead entity.");
+			}
+			return getComponents<T>().add(id.index, component);
+		}
+		template<class T>
+		T* getComponent(const ComponentId& id) {
+			return isAlive(id) ? getComponents<T>().get(id.index) : 0;
+		}
+		template<class T>
+		bool hasComponent(const ComponentId& id) {
+			return isAlive(id) && getComponents<T>().has(id.index);
+		}
+		template<class T>
+		void removeComponent(const ComponentId& id) {
+			if(isAlive(id)) {
+				getComponents<T>().remove(id.index);
+			}
+		}
+		ComponentId getId(uint32_t index) const;
+
+		void init();
+		void update(unsigned long elapsed_millis);
+		void draw();
+		void drawOverlay();
+	};
+}
+
+#endif // COMPONENT_STORE_H
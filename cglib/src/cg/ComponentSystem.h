@@ -0,0 +1,48 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef COMPONENT_SYSTEM_H
+#define COMPONENT_SYSTEM_H
+
+#include <string>
+
+namespace cg {
+
+	class ComponentStore;
+
+	/** cg::ComponentSystem is the base class of the systems of a
+	 *  cg::ComponentStore. Each step of the simulation cycle is forwarded by
+	 *  the store to its systems, in the order they were added, and a system
+	 *  implements the steps it needs by iterating the components of the store.
+	 */
+	class ComponentSystem {
+	protected:
+		std::string _name;
+
+	public:
+		ComponentSystem(const std::string& name) : _name(name) {}
+		virtual ~ComponentSystem() {}
+
+		const std::string& getName() const { return _name; }
+		virtual void init(ComponentStore& store) {}
+		virtual void update(ComponentStore& store, unsigned long elapsed_millis) {}
+		virtual void draw(ComponentStore& store) {}
+		virtual void drawOverlay(ComponentStore& store) {}
+	};
+}
+
+#endif // COMPONENT_SYSTEM_H
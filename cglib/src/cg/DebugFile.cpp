@@ -17,9 +17,49 @@
 // Copyright 2007 Carlos Martinho
 
 #include "DebugFile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <time.h>
+#include "Clock.h"
 
 namespace cg {
 
+	static const unsigned int RING_SIZE = 1024;
+	static const unsigned int RECORD_TEXT = 232;
+	static const long WRITER_SLEEP_NANOS = 2000000;
+	static const char* LEVEL_NAMES[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+	// Messages longer than RECORD_TEXT are copied to the heap.
+	typedef struct {
+		uint64_t time;
+		DebugFile::tLevel level;
+		bool newline;
+		unsigned int length;
+		std::string* overflow;
+		char text[RECORD_TEXT];
+	} tDebugRecord;
+
+	// Single producer (the owning thread), single consumer (whoever holds
+	// the file mutex). head and tail only grow; RING_SIZE is a power of two.
+	struct DebugFileRing {
+		tDebugRecord records[RING_SIZE];
+		unsigned int head;
+		unsigned int tail;
+		unsigned long dropped;
+		bool isAbandoned;
+	};
+
+	typedef struct {
+		tDebugRecord* record;
+		DebugFileRing* ring;
+	} tQueuedRecord;
+
+	static bool isEarlier(const tQueuedRecord& a, const tQueuedRecord& b) {
+		return a.record->time < b.record->time;
+	}
+
     DebugFile* DebugFile::_instance = 0;
 
     DebugFile* DebugFile::instance() {
@@ -30,26 +70,260 @@ namespace cg {
 	}
     DebugFile::DebugFile() {
 		_file.open("log.txt");
+		_level = LEVEL_INFO;
+		_start = Clock::nanoseconds();
+		_openLineRing = 0;
+		_reportedDropped = 0;
+		_exitedDropped = 0;
+		_isRunning = true;
+		pthread_key_create(&_ringKey, abandonRing);
+		pthread_mutex_init(&_ringsMutex, 0);
+		// Recursive, so that errors can be reported and locks nested
+		// while a cg::DebugFileLock is held
+		pthread_mutexattr_t attributes;
+		pthread_mutexattr_init(&attributes);
+		pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&_fileMutex, &attributes);
+		pthread_mutexattr_destroy(&attributes);
+		if (pthread_create(&_writer, 0, writerMain, this) != 0) {
+			throw std::runtime_error("[cg::DebugFile] could not create the writer thread.");
+		}
+		static bool isAtExitRegistered = false;
+		if (!isAtExitRegistered) {
+			atexit(flushAtExit);
+			isAtExitRegistered = true;
+		}
 	}
     DebugFile::~DebugFile() {
 	}
     void DebugFile::cleanup() {
+		__atomic_store_n(&_isRunning, false, __ATOMIC_RELEASE);
+		pthread_join(_writer, 0);
+		pthread_mutex_lock(&_fileMutex);
+		drain();
 		_file.close();
+		pthread_mutex_unlock(&_fileMutex);
+		pthread_key_delete(_ringKey);
+		for (unsigned int i = 0; i < _rings.size(); i++) {
+			delete _rings[i];
+		}
+		_rings.clear();
+		pthread_mutex_destroy(&_fileMutex);
+		pthread_mutex_destroy(&_ringsMutex);
 		delete _instance;
+		_instance = 0;
+	}
+	void* DebugFile::writerMain(void* debug_file) {
+		DebugFile* file = (DebugFile*)debug_file;
+		while (__atomic_load_n(&file->_isRunning, __ATOMIC_ACQUIRE)) {
+			pthread_mutex_lock(&file->_fileMutex);
+			bool wrote = file->drain();
+			pthread_mutex_unlock(&file->_fileMutex);
+			if (!wrote) {
+				struct timespec ts = { 0, WRITER_SLEEP_NANOS };
+				nanosleep(&ts, 0);
+			}
+		}
+		return 0;
+	}
+	// Writes what is still queued if the process exits without cleanup.
+	void DebugFile::flushAtExit() {
+		if (_instance != 0) {
+			_instance->flush();
+		}
+	}
+	void DebugFile::abandonRing(void* ring) {
+		__atomic_store_n(&((DebugFileRing*)ring)->isAbandoned, true, __ATOMIC_RELEASE);
+	}
+	DebugFileRing* DebugFile::getRing() {
+		DebugFileRing* ring = (DebugFileRing*)pthread_getspecific(_ringKey);
+		if (ring == 0) {
+			ring = new DebugFileRing();
+			ring->head = ring->tail = 0;
+			ring->dropped = 0;
+			ring->isAbandoned = false;
+			pthread_mutex_lock(&_ringsMutex);
+			_rings.push_back(ring);
+			pthread_mutex_unlock(&_ringsMutex);
+			pthread_setspecific(_ringKey, ring);
+		}
+		return ring;
+	}
+	// Errors usually precede a rethrow that may end the process, so they
+	// are never dropped and are written before returning.
+	void DebugFile::push(tLevel level, const std::string& s, bool newline) {
+		if (!isEnabled(level)) {
+			return;
+		}
+		bool is_synchronous = (level == LEVEL_ERROR);
+		DebugFileRing* ring = getRing();
+		unsigned int head = ring->head;
+		if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= RING_SIZE) {
+			if (!is_synchronous) {
+				__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+				return;
+			}
+			flush();
+		}
+		tDebugRecord& record = ring->records[head & (RING_SIZE - 1)];
+		record.time = Clock::nanoseconds();
+		record.level = level;
+		record.newline = newline;
+		if (s.size() <= RECORD_TEXT) {
+			memcpy(record.text, s.data(), s.size());
+			record.length = s.size();
+			record.overflow = 0;
+		} else {
+			record.length = 0;
+			record.overflow = new std::string(s);
+		}
+		__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+		if (is_synchronous) {
+			flush();
+		}
+	}
+	// Writes every queued record in time order. Must hold _fileMutex.
+	bool DebugFile::drain() {
+		pthread_mutex_lock(&_ringsMutex);
+		std::vector<DebugFileRing*> rings(_rings);
+		unsigned long dropped = _exitedDropped;
+		pthread_mutex_unlock(&_ringsMutex);
+
+		std::vector<unsigned int> heads(rings.size());
+		std::vector<tQueuedRecord> records;
+		for (unsigned int i = 0; i < rings.size(); i++) {
+			heads[i] = __atomic_load_n(&rings[i]->head, __ATOMIC_ACQUIRE);
+			for (unsigned int t = rings[i]->tail; t != heads[i]; t++) {
+				tQueuedRecord queued = { &rings[i]->records[t & (RING_SIZE - 1)], rings[i] };
+				records.push_back(queued);
+			}
+			dropped += __atomic_load_n(&rings[i]->dropped, __ATOMIC_RELAXED);
+		}
+		std::stable_sort(records.begin(), records.end(), isEarlier);
+		for (unsigned int i = 0; i < records.size(); i++) {
+			tDebugRecord* record = records[i].record;
+			// Never append to another thread's unfinished line
+			if (_openLineRing != 0 && _openLineRing != records[i].ring) {
+				endLine();
+			}
+			if (_openLineRing == 0) {
+				_file << std::fixed << std::setprecision(6) << std::setw(11) << (record->time - _start) * 1e-9
+					  << " " << std::left << std::setw(7) << LEVEL_NAMES[record->level] << std::right << " ";
+				_file.unsetf(std::ios::floatfield);
+			}
+			if (record->overflow) {
+				_file << *record->overflow;
+				delete record->overflow;
+			} else {
+				_file.write(record->text, record->length);
+			}
+			if (record->newline) {
+				_file << '\n';
+			}
+			_openLineRing = record->newline ? 0 : records[i].ring;
+		}
+		for (unsigned int i = 0; i < rings.size(); i++) {
+			__atomic_store_n(&rings[i]->tail, heads[i], __ATOMIC_RELEASE);
+		}
+		if (dropped > _reportedDropped) {
+			endLine();
+			_file << "[cg::DebugFile] " << dropped - _reportedDropped << " messages dropped" << std::endl;
+			_reportedDropped = dropped;
+		}
+		if (!records.empty()) {
+			_file.flush();
+		}
+
+		// Free the rings of threads that have exited, once empty
+		pthread_mutex_lock(&_ringsMutex);
+		for (unsigned int i = 0; i < _rings.size(); ) {
+			DebugFileRing* ring = _rings[i];
+			if (__atomic_load_n(&ring->isAbandoned, __ATOMIC_ACQUIRE)
+					&& ring->tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+				_exitedDropped += ring->dropped;
+				if (_openLineRing == ring) {
+					endLine();
+				}
+				delete ring;
+				_rings[i] = _rings.back();
+				_rings.pop_back();
+			} else {
+				i++;
+			}
+		}
+		pthread_mutex_unlock(&_ringsMutex);
+		return !records.empty();
+	}
+	// Ends the unfinished line, if any. Must hold _fileMutex.
+	void DebugFile::endLine() {
+		if (_openLineRing != 0) {
+			_file << '\n';
+			_openLineRing = 0;
+		}
+	}
+	DebugFile::tLevel DebugFile::parseLevel(const std::string& name) {
+		for (int level = LEVEL_DEBUG; level <= LEVEL_ERROR; level++) {
+			if (name == LEVEL_NAMES[level]) {
+				return (tLevel)level;
+			}
+		}
+		throw std::runtime_error("[cg::DebugFile] unknown log level '" + name + "'.");
+	}
+	void DebugFile::setLevel(tLevel level) {
+		__atomic_store_n(&_level, level, __ATOMIC_RELAXED);
+	}
+	DebugFile::tLevel DebugFile::getLevel() const {
+		return __atomic_load_n(&_level, __ATOMIC_RELAXED);
 	}
-	std::ofstream& DebugFile::getOutputFileStream() {
-		return _file;
+	bool DebugFile::isEnabled(tLevel level) const {
+		return level >= getLevel();
 	}
 	void DebugFile::write(const std::string& s) {
-		_file << s;
+		push(LEVEL_INFO, s, false);
 	}
 	void DebugFile::writeLine(const std::string& s) {
-		_file << s << std::endl;
+		push(LEVEL_INFO, s, true);
+	}
+	void DebugFile::writeLine(tLevel level, const std::string& s) {
+		push(level, s, true);
 	}
 	void DebugFile::newLine() {
-		_file << std::endl;
+		push(LEVEL_INFO, "", true);
 	}
 	void DebugFile::writeException(std::runtime_error& e) {
-		_file << "(EXCEPTION) " << e.what() << std::endl;
+		push(LEVEL_ERROR, std::string("(EXCEPTION) ") + e.what(), true);
+	}
+	void DebugFile::flush() {
+		pthread_mutex_lock(&_fileMutex);
+		drain();
+		_file.flush();
+		pthread_mutex_unlock(&_fileMutex);
+	}
+	unsigned long DebugFile::getDroppedCount() {
+		pthread_mutex_lock(&_ringsMutex);
+		unsigned long dropped = _exitedDropped;
+		for (unsigned int i = 0; i < _rings.size(); i++) {
+			dropped += __atomic_load_n(&_rings[i]->dropped, __ATOMIC_RELAXED);
+		}
+		pthread_mutex_unlock(&_ringsMutex);
+		return dropped;
+	}
+
+	DebugFileLock::DebugFileLock() {
+		_debugFile = DebugFile::instance();
+		pthread_mutex_lock(&_debugFile->_fileMutex);
+		_debugFile->drain();
+		_debugFile->endLine();
+		_flags = _debugFile->_file.flags();
+		_precision = _debugFile->_file.precision();
+	}
+	DebugFileLock::~DebugFileLock() {
+		_debugFile->_file.flags(_flags);
+		_debugFile->_file.precision(_precision);
+		_debugFile->_file.flush();
+		pthread_mutex_unlock(&_debugFile->_fileMutex);
+	}
+	std::ofstream& DebugFileLock::getOutputFileStream() {
+		return _debugFile->_file;
 	}
 }
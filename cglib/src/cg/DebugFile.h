@@ -20,34 +20,102 @@
 #define DEBUG_FILE_H
 
 #include <fstream>
+#include <pthread.h>
+#include <stdint.h>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 namespace cg {
 
+	struct DebugFileRing;
+
 	/** cg::DebugFile is singleton class that writes to a single text
 	 *  file for debug purposes. Any class can write to this file using
 	 *  the methods cg::DebugFile::write, cg::DebugFile::writeLine and
 	 *  cg::DebugFile::newLine. Alternatively, any class can get the
-	 *  direct output file stream handle through the method
-	 *  cg::DebugFile::getOutputFileStream.
+	 *  direct output file stream handle through a cg::DebugFileLock.
+	 *  Writes never block: each thread queues its messages, with a level
+	 *  and a cg::Clock timestamp, in its own lock-free ring buffer, and a
+	 *  background thread merges them in time order into the file, each
+	 *  line prefixed by the seconds elapsed since the file was opened and
+	 *  the level. A line written in pieces with cg::DebugFile::write is
+	 *  ended early, and its rest prefixed again, when another thread's
+	 *  message comes between the pieces. If a thread's buffer is full the
+	 *  message is dropped, and the number of dropped messages is reported
+	 *  in the file. Errors are the exception: they are written before
+	 *  cg::DebugFile::writeException or cg::DebugFile::writeLine returns,
+	 *  so they survive a rethrow that terminates the process.
+	 *  Messages below the level set with cg::DebugFile::setLevel (INFO by
+	 *  default, or LOG_LEVEL in the application properties) are discarded.
 	 */
 	class DebugFile  {
+		friend class DebugFileLock;
+
+	public:
+		typedef enum { LEVEL_DEBUG, LEVEL_INFO, LEVEL_WARNING, LEVEL_ERROR } tLevel;
 
 	private:
 		static DebugFile* _instance;
 		DebugFile();
 		std::ofstream _file;
+		tLevel _level;
+		uint64_t _start;
+		DebugFileRing* _openLineRing;
+		unsigned long _reportedDropped;
+		unsigned long _exitedDropped;
+		bool _isRunning;
+		pthread_t _writer;
+		pthread_key_t _ringKey;
+		pthread_mutex_t _ringsMutex;
+		pthread_mutex_t _fileMutex;
+		std::vector<DebugFileRing*> _rings;
+
+		static void* writerMain(void* debug_file);
+		static void abandonRing(void* ring);
+		static void flushAtExit();
+		DebugFileRing* getRing();
+		void push(tLevel level, const std::string& s, bool newline);
+		bool drain();
+		void endLine();
 
 	public:
 		static DebugFile* instance();
+		static tLevel parseLevel(const std::string& name);
 		virtual ~DebugFile();
 		void cleanup();
-		std::ofstream& getOutputFileStream();
+		void setLevel(tLevel level);
+		tLevel getLevel() const;
+		bool isEnabled(tLevel level) const;
 		void write(const std::string& s);
 		void writeLine(const std::string& s);
+		void writeLine(tLevel level, const std::string& s);
 		void newLine();
 		void writeException(std::runtime_error& e);
+		void flush();
+		unsigned long getDroppedCount();
+	};
+
+	/** cg::DebugFileLock gives its owner exclusive access to the output
+	 *  file stream of cg::DebugFile until it goes out of scope. The queues
+	 *  are flushed first and the background writer waits meanwhile, so
+	 *  writes through the stream are unprefixed and land in one piece.
+	 *  Format flags changed through the stream are restored on release.
+	 *  Locks can be nested in the same thread.
+	 */
+	class DebugFileLock {
+
+	private:
+		DebugFile* _debugFile;
+		std::ios::fmtflags _flags;
+		std::streamsize _precision;
+		DebugFileLock(const DebugFileLock&);
+		DebugFileLock& operator=(const DebugFileLock&);
+
+	public:
+		DebugFileLock();
+		~DebugFileLock();
+		std::ofstream& getOutputFileStream();
 	};
 }
 
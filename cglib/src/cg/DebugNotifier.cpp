@@ -23,7 +23,8 @@ namespace cg {
 	SINGLETON_IMPLEMENTATION(DebugNotifier)
 
 	void DebugNotifier::debug() {
-		std::ofstream& file = DebugFile::instance()->getOutputFileStream();
+		DebugFileLock debug_file_lock;
+		std::ofstream& file = debug_file_lock.getOutputFileStream();
 		FOR_EACH_LISTENER(debug(file))
 	}
 }
@@ -0,0 +1,89 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef DISPATCH_LIST_H
+#define DISPATCH_LIST_H
+
+#include <stdint.h>
+#include <vector>
+#include "Entity.h"
+#include "State.h"
+
+namespace cg {
+
+	class ProfileSeries;
+
+	/** cg::DispatchEntry<E> is what a dispatch loop needs to call one
+	 *  listener: the interface pointer and the state of its entity,
+	 *  both resolved when the entry is built, and its entity, whose id
+	 *  names the cg::Tracer scope of the callback once traceName is set.
+	 *  The profile member is present whether or not CG_PROFILE is defined,
+	 *  so that the layout of the entry, which is instantiated in both cglib
+	 *  and the application, does not depend on the macro.
+	 */
+	template<class E>
+	struct DispatchEntry {
+		E* listener;
+		const State* state;
+		Entity* entity;
+		uint32_t traceName;
+		ProfileSeries* profile;
+	};
+
+	/** cg::DispatchList<E> is a contiguous array of cg::DispatchEntry<E>,
+	 *  rebuilt from an owning cg::LockableOrderedMap only when the version
+	 *  of the map changes, so that dispatching is a flat loop with neither
+	 *  per-element indirections nor casts.
+	 */
+	template<class E>
+	class DispatchList {
+	private:
+		std::vector<DispatchEntry<E> > _entries;
+		unsigned long _version;
+		bool _isValid;
+
+	public:
+		DispatchList() : _version(0), _isValid(false) {}
+		~DispatchList() {}
+
+		bool isCurrent(unsigned long version) const {
+			return _isValid && _version == version;
+		}
+		void reset(unsigned long version) {
+			_entries.clear();
+			_version = version;
+			_isValid = true;
+		}
+		void add(E* listener, Entity* entity) {
+			DispatchEntry<E> entry;
+			entry.listener = listener;
+			entry.state = &entity->state;
+			entry.entity = entity;
+			entry.traceName = 0;
+			entry.profile = 0;
+			_entries.push_back(entry);
+		}
+		DispatchEntry<E>* begin() {
+			return _entries.empty() ? 0 : &_entries[0];
+		}
+		DispatchEntry<E>* end() {
+			return _entries.empty() ? 0 : &_entries[0] + _entries.size();
+		}
+	};
+}
+
+#endif // DISPATCH_LIST_H
@@ -23,6 +23,7 @@ namespace cg {
 	SINGLETON_IMPLEMENTATION(DrawNotifier)
 
 	void DrawNotifier::draw() {
-		FOR_EACH_LISTENER(draw())
+		CG_TRACE_SCOPE("draw")
+		FOR_EACH_LISTENER_PROFILED(draw(), "draw")
 	}
 }
@@ -23,6 +23,7 @@ namespace cg {
 	SINGLETON_IMPLEMENTATION(DrawOverlayNotifier)
 
 	void DrawOverlayNotifier::drawOverlay() {
-		FOR_EACH_LISTENER(drawOverlay())
+		CG_TRACE_SCOPE("drawOverlay")
+		FOR_EACH_LISTENER_PROFILED(drawOverlay(), "drawOverlay")
 	}
 }
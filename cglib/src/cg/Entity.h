@@ -21,18 +21,26 @@
 
 #include <string>
 #include <fstream>
+#include "EntityHandle.h"
 #include "State.h"
 
 namespace cg {
 
+	class Registry;
+
 	/** cg::Entity is the base class of all simulation objects.
 	 *  A cg::Entity has a string identifier and can be turned on or off.
 	 *  When turned off, all callbacks will be disabled. 
 	 *  All initialization of the object should be performed in the init() 
 	 *  method: only by then, OpenGL commands are ready to be used.
+	 *  Once added to the cg::Registry, a cg::Entity knows its cg::EntityHandle.
 	 */
 	class Entity {
 
+	private:
+		EntityHandle _handle;
+		friend class Registry;
+
 	protected:
 		std::string _id;
 
@@ -43,6 +51,7 @@ namespace cg {
 		virtual ~Entity() {}
 
 		const std::string& getId() const { return _id; }
+		const EntityHandle& getHandle() const { return _handle; }
 		virtual void init() = 0;
 
 		virtual void dump(std::ofstream& file) {
@@ -0,0 +1,52 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef ENTITY_HANDLE_H
+#define ENTITY_HANDLE_H
+
+#include <stdint.h>
+
+namespace cg {
+
+	/** cg::EntityHandle identifies a cg::Entity in the cg::Registry by the
+	 *  index of its slot and the generation of that slot when the entity was
+	 *  added. Removing an entity increments the generation of its slot, so
+	 *  handles to removed entities are detected as stale even after the slot
+	 *  has been reused. The default handle (generation 0) is the null handle.
+	 */
+	struct EntityHandle {
+		uint32_t index;
+		uint32_t generation;
+
+		EntityHandle() : index(0), generation(0) {}
+		EntityHandle(uint32_t i, uint32_t g) : index(i), generation(g) {}
+		bool isNull() const { return generation == 0; }
+		// The generation a slot takes when its entity is removed, skipping 0.
+		static uint32_t nextGeneration(uint32_t generation) {
+			uint32_t next = generation + 1;
+			return next == 0 ? 1 : next;
+		}
+		bool operator==(const EntityHandle& h) const {
+			return index == h.index && generation == h.generation;
+		}
+		bool operator!=(const EntityHandle& h) const {
+			return !(*this == h);
+		}
+	};
+}
+
+#endif // ENTITY_HANDLE_H
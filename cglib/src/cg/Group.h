@@ -21,18 +21,18 @@
 
 #include <fstream>
 #include <string>
+#include "DispatchList.h"
 #include "Entity.h"
 #include "LockableOrderedMap.h"
 
 #define FOR_EACH_ENTITY(COMMAND,INTERFACE)\
 	try {\
-		LockableOrderedMap<Entity>* lomap = getEntities();\
+		LockableOrderedMap<Entity>* lomap = _dispatch##INTERFACE.refresh(this);\
 		lomap->lock();\
-		LockableOrderedMap<Entity>::iterator iend = end();\
-		for (LockableOrderedMap<Entity>::iterator i = begin(); i != iend; i++) {\
-			if((*i)->state.isEnabled()) {\
-				INTERFACE* obj = dynamic_cast<INTERFACE*>(*i);\
-				obj->COMMAND; }}\
+		DispatchEntry<INTERFACE>* iend = _dispatch##INTERFACE.end();\
+		for (DispatchEntry<INTERFACE>* i = _dispatch##INTERFACE.begin(); i != iend; i++) {\
+			if(i->state->isEnabled()) {\
+				i->listener->COMMAND; }}\
 		lomap->unlock();\
 	} catch(std::runtime_error& e) {\
 		cg::DebugFile::instance()->writeException(e);\
@@ -50,6 +50,12 @@
 		Group* group = (Group*)dynamic_cast<Group*>(this);\
 		return group->end(); }
 
+/** GROUP_DISPATCH(INTERFACE) declares the cg::GroupDispatch<INTERFACE>
+ *  used by FOR_EACH_ENTITY(COMMAND,INTERFACE).
+ */
+#define GROUP_DISPATCH(INTERFACE)\
+	private: GroupDispatch<INTERFACE> _dispatch##INTERFACE;
+
 namespace cg {
 
 	class IGetEntities {
@@ -61,6 +67,43 @@ namespace cg {
 		virtual ~IGetEntities(){}
     };
 
+	/** cg::GroupDispatch<E> caches, for one group, the entities implementing
+	 *  E. The casts are done when the entities of the group change, and the
+	 *  entities that do not implement E are left out.
+	 */
+	template<class E>
+	class GroupDispatch {
+	private:
+		LockableOrderedMap<Entity>* _entities;
+		DispatchList<E> _list;
+
+	public:
+		GroupDispatch() : _entities(0) {}
+		~GroupDispatch() {}
+
+		LockableOrderedMap<Entity>* refresh(IGetEntities* group) {
+			if(_entities == 0) {
+				_entities = group->getEntities();
+			}
+			if(!_list.isCurrent(_entities->getVersion())) {
+				_list.reset(_entities->getVersion());
+				for (LockableOrderedMap<Entity>::iterator i = _entities->begin(); i != _entities->end(); i++) {
+					E* listener = dynamic_cast<E*>(*i);
+					if(listener != 0) {
+						_list.add(listener, *i);
+					}
+				}
+			}
+			return _entities;
+		}
+		DispatchEntry<E>* begin() {
+			return _list.begin();
+		}
+		DispatchEntry<E>* end() {
+			return _list.end();
+		}
+	};
+
 	/** cg::Group is an entity that contains other entities.
 	 *  Group can implement the same interfaces as any entity plus the
 	 *  specific group classes that automatically distribute events
@@ -33,6 +33,7 @@ namespace cg {
 	protected:
 		virtual void preDebug(std::ofstream& file) {}
 		virtual void postDebug(std::ofstream& file) {}
+		GROUP_DISPATCH(IDebugListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		virtual void debug(std::ofstream& file) {
@@ -32,6 +32,7 @@ namespace cg {
 	protected:
 		virtual void preDraw() {}
 		virtual void postDraw() {}
+		GROUP_DISPATCH(IDrawListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		virtual void draw() {
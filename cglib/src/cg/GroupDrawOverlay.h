@@ -33,6 +33,7 @@ namespace cg {
 	protected:
 		virtual void preDrawOverlay() {}
 		virtual void postDrawOverlay() {}
+		GROUP_DISPATCH(IDrawOverlayListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		virtual void drawOverlay() {
@@ -39,6 +39,7 @@ namespace cg {
 		virtual void postOnSpecialKeyPressed(int key) {}
 		virtual void preOnSpecialKeyReleased(int key) {}
 		virtual void postOnSpecialKeyReleased(int key) {}
+		GROUP_DISPATCH(IKeyboardEventListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		void onKeyPressed(unsigned char key) {
@@ -37,6 +37,7 @@ namespace cg {
 		virtual void postOnMouseMotion(int x, int y) {}
 		virtual void preOnMousePassiveMotion(int x, int y) {}
 		virtual void postOnMousePassiveMotion(int x, int y) {}
+		GROUP_DISPATCH(IMouseEventListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		void onMouse(int button, int state, int x, int y) {
@@ -33,6 +33,7 @@ namespace cg {
 	protected:
 		virtual void preOnReshape(int width, int height) {}
 		virtual void postOnReshape(int width, int height) {}
+		GROUP_DISPATCH(IReshapeEventListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		virtual void onReshape(int width, int height) {
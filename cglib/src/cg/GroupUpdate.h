@@ -33,6 +33,7 @@ namespace cg {
 	protected:
 		virtual void preUpdate(unsigned long elapsed_millis) {}
 		virtual void postUpdate(unsigned long elapsed_millis) {}
+		GROUP_DISPATCH(IUpdateListener)
     public:
 		IGETENTITIES_IMPLEMENTATION
 		virtual void update(unsigned long elapsed_millis) {
@@ -22,6 +22,8 @@
 namespace cg {
 
 	/** cg::IDrawListener is the callback interface for the draw step.
+	 *  When the application runs with a fixed time step, listeners may use
+	 *  cg::Application::getTime().alpha to interpolate their drawn state.
 	 */
 	class IDrawListener {
     public:
@@ -0,0 +1,37 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef IPROPERTY_LISTENER_H
+#define IPROPERTY_LISTENER_H
+
+#include <string>
+
+namespace cg {
+
+	/** cg::IPropertyListener is the callback interface for changes of a
+	 *  property subscribed to with cg::Properties::subscribe.
+	 */
+	class IPropertyListener {
+    public:
+        virtual void onPropertyChanged(const std::string& name) = 0;
+
+        virtual ~IPropertyListener(){}
+    };
+
+}
+
+#endif // IPROPERTY_LISTENER_H
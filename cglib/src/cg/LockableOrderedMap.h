@@ -27,18 +27,41 @@
 
 namespace cg {
 
+	/** cg::LockableOrderedMap<T> is a set of named elements kept in a dense
+	 *  array. While locked, additions and removals are buffered in a
+	 *  cg::CommandQueue<T> and only applied on unlock, so that the array can
+	 *  be safely iterated. On a locked map, exists, get and the check for a
+	 *  duplicate name in add already see the queued commands, so adding an
+	 *  existing name throws at once. Each name maps to the slot of its
+	 *  element, so a removal costs the name lookup plus a constant time
+	 *  update of the array.
+	 *  By default, the insertion order of the elements is preserved: removed
+	 *  slots are marked as tombstones, and the array is compacted in a single
+	 *  pass before it is next iterated (cg::LockableOrderedMap::begin/end),
+	 *  which also covers all the removals applied together on unlock.
+	 *  With cg::LockableOrderedMap::setPreserveOrder(false), a removal moves
+	 *  the last element into the freed slot instead, and no compaction is
+	 *  ever needed.
+	 */
 	template <class T>
 	class LockableOrderedMap {
 
 	private:
-		std::map<const std::string,T*> _names;
-		typedef typename std::map<const std::string,T*>::iterator tNameIterator;
+		std::map<const std::string,unsigned int> _names;
+		typedef typename std::map<const std::string,unsigned int>::iterator tNameIterator;
 
 		std::vector<T*> _elements;
+		std::vector<tNameIterator> _keys;
 		typedef typename std::vector<T*>::iterator tElementIterator;
 
 		bool _isLocked;
 		CommandQueue<T> _commandQueue;
+		unsigned long _version;
+		bool _preserveOrder;
+		unsigned int _tombstones;
+
+		void removeSlot(unsigned int slot);
+		void compact();
 
 	public:
 		LockableOrderedMap();
@@ -49,9 +72,12 @@ namespace cg {
 		tElementIterator end();
 
 		unsigned int size() const;
+		unsigned long getVersion() const;
+		void setPreserveOrder(bool preserve_order);
+		bool isPreservingOrder() const;
 		bool exists(const std::string& id);
 		T* get(const std::string& id);
-		void add(std::string id, T* element);
+		void add(const std::string& id, T* element);
 		void remove(const std::string& id);
 		void removeAll();
 		void destroy(const std::string& id);
@@ -64,6 +90,9 @@ namespace cg {
     template<class T>
     LockableOrderedMap<T>::LockableOrderedMap() {
 		_isLocked = false;
+		_version = 0;
+		_preserveOrder = true;
+		_tombstones = 0;
     }
     template<class T>
     LockableOrderedMap<T>::~LockableOrderedMap() {
@@ -72,92 +101,160 @@ namespace cg {
     }
     template<class T>
     typename LockableOrderedMap<T>::iterator LockableOrderedMap<T>::begin() {
+		if(_tombstones) {
+			compact();
+		}
 		return _elements.begin();
 	}
     template<class T>
     typename LockableOrderedMap<T>::iterator LockableOrderedMap<T>::end() {
+		if(_tombstones) {
+			compact();
+		}
 		return _elements.end();
 	}
 	template<class T>
     unsigned int LockableOrderedMap<T>::size() const{
 		return (unsigned int)_names.size();
     }
+	// Incremented whenever elements are effectively added or removed.
+	template<class T>
+    unsigned long LockableOrderedMap<T>::getVersion() const {
+		return _version;
+    }
+	template<class T>
+    void LockableOrderedMap<T>::setPreserveOrder(bool preserve_order) {
+		if(_tombstones) {
+			compact();
+		}
+		_preserveOrder = preserve_order;
+    }
+	template<class T>
+    bool LockableOrderedMap<T>::isPreservingOrder() const {
+		return _preserveOrder;
+    }
+	// On a locked map, the commands queued so far are taken into account.
     template<class T>
     bool LockableOrderedMap<T>::exists(const std::string& id) {
-		if(_names.count(id) == 0) {
-			return _commandQueue.existsElement(id);
-		} else {
-			return true;
-		}
+		return get(id) != 0;
     }
 	template <class T>
 	T* LockableOrderedMap<T>::get(const std::string& id) {
+		if(_isLocked) {
+			T* element = _commandQueue.getElement(id);
+			if(element != 0 || _commandQueue.isRemoved(id)) {
+				return element;
+			}
+		}
 		tNameIterator i = _names.find(id);
 		if(i == _names.end()) {
-			return _commandQueue.getElement(id);
+			return 0;
 		} else {
-			return i->second;
+			return _elements[i->second];
 		}
 	}
 	template <class T>
-	void LockableOrderedMap<T>::add(std::string id, T* element) {
+	void LockableOrderedMap<T>::add(const std::string& id, T* element) {
 		if(_isLocked) {
-			_commandQueue.add(new AddCommand<T>(id,element));
-			_commandQueue.addElement(id,element);
+			if(exists(id)) {
+				throw std::runtime_error("[cg::ActivityMap] element '" + id + "' already exists.");
+			}
+			_commandQueue.add(Command<T>::ADD, id, element);
 		} else {
-			std::pair<tNameIterator,bool> result = _names.insert(std::make_pair(id, element));
+			std::pair<tNameIterator,bool> result = _names.insert(std::make_pair(id, (unsigned int)_elements.size()));
 			if(result.second == false) {
 				throw std::runtime_error("[cg::ActivityMap] element '" + id + "' already exists.");
 			}
 			_elements.push_back(element);
+			_keys.push_back(result.first);
+			_version++;
+		}
+	}
+	// Tombstone the slot, or swap-and-pop when the order does not matter.
+	template <class T>
+	void LockableOrderedMap<T>::removeSlot(unsigned int slot) {
+		tNameIterator removed = _keys[slot];
+		if(_preserveOrder) {
+			_elements[slot] = 0;
+			_keys[slot] = _names.end();
+			_tombstones++;
+		} else {
+			unsigned int last = (unsigned int)_elements.size() - 1;
+			if(slot != last) {
+				_elements[slot] = _elements[last];
+				_keys[slot] = _keys[last];
+				_keys[slot]->second = slot;
+			}
+			_elements.pop_back();
+			_keys.pop_back();
+		}
+		_names.erase(removed);
+		_version++;
+	}
+	template <class T>
+	void LockableOrderedMap<T>::compact() {
+		unsigned int j = 0;
+		for(unsigned int i = 0; i < _elements.size(); i++) {
+			if(_elements[i] != 0) {
+				_elements[j] = _elements[i];
+				_keys[j] = _keys[i];
+				_keys[j]->second = j;
+				j++;
+			}
 		}
+		_elements.resize(j);
+		_keys.resize(j, _names.end());
+		_tombstones = 0;
 	}
 	template <class T>
 	void LockableOrderedMap<T>::remove(const std::string& id) {
 		if(_isLocked) {
-			_commandQueue.add(new RemoveCommand<T>(id));
+			_commandQueue.add(Command<T>::REMOVE, id, 0);
 		} else {
 			tNameIterator i = _names.find(id);
 			if(i != _names.end()) {
-				tElementIterator j = find(_elements.begin(), _elements.end(), i->second);
-				_elements.erase(j);
-				_names.erase(id);
+				removeSlot(i->second);
 			}
 		}
 	}
 	template <class T>
 	void LockableOrderedMap<T>::removeAll() {
 		if(_isLocked) {
-			_commandQueue.add(new RemoveAllCommand<T>());
+			_commandQueue.add(Command<T>::REMOVE_ALL);
 		} else {
 			_elements.clear();
+			_keys.clear();
 			_names.clear();
+			_tombstones = 0;
+			_version++;
 		}
 	}
 	template <class T>
 	void LockableOrderedMap<T>::destroy(const std::string& id) {
 		if(_isLocked) {
-			_commandQueue.add(new DestroyCommand<T>(id));
+			_commandQueue.add(Command<T>::DESTROY, id, 0);
 		} else {
 			tNameIterator i = _names.find(id);
 			if(i != _names.end()) {
-				tElementIterator j = find(_elements.begin(), _elements.end(), i->second);
-				delete (*j);
-				_elements.erase(j);
-				_names.erase(id);
+				unsigned int slot = i->second;
+				delete _elements[slot];
+				removeSlot(slot);
 			}
 		}
 	}
 	template <class T>
 	void LockableOrderedMap<T>::destroyAll() {
 		if(_isLocked) {
-			_commandQueue.add(new DestroyAllCommand<T>());
+			_commandQueue.add(Command<T>::DESTROY_ALL);
 		} else {
 			for (tElementIterator i = _elements.begin(); i != _elements.end(); i++) {
 				delete (*i);
 			}
 			_elements.clear();
+			_keys.clear();
 			_names.clear();
+			_tombstones = 0;
+			_version++;
 		}
 	}
 	template <class T>
@@ -17,6 +17,8 @@
 // Copyright 2007 Carlos Martinho
 
 #include "Manager.h"
+#include <sstream>
+#include <time.h>
 
 namespace cg {
 
@@ -35,6 +37,7 @@ namespace cg {
     }
     void appDisplayCallback() {
         Manager::instance()->getApp()->onDisplay();
+        CG_TRACE_SCOPE("glutSwapBuffers")
         glutSwapBuffers();
     }
 
@@ -83,6 +86,14 @@ namespace cg {
         return _app;
     }
     void Manager::runApp(Application *app, int fps, int glut_argc, char** glut_argv) {
+        Properties* properties = Properties::instance();
+        if(properties->exists("HEADLESS") && properties->getInt("HEADLESS")) {
+            runAppHeadless(app,
+                properties->exists("HEADLESS_FPS") ? properties->getInt("HEADLESS_FPS") : 0,
+                properties->exists("HEADLESS_FRAMES") ? properties->getInt("HEADLESS_FRAMES") : 0,
+                properties->exists("HEADLESS_SECONDS") ? properties->getDouble("HEADLESS_SECONDS") : 0);
+            return;
+        }
         _app = app;
         _intervalMillis = 1000 / fps;
         glutInit(&glut_argc, glut_argv);
@@ -105,6 +116,43 @@ namespace cg {
         glutSpecialUpFunc(appSpecialKeyReleasedCallback);
         glutTimerFunc(_intervalMillis,appUpdateCallback,0);
         glutMainLoop();
+    }
+    void Manager::runAppHeadless(Application *app, int fps, unsigned long frames, double seconds) {
+        _app = app;
+        _intervalMillis = (fps > 0) ? 1000 / fps : 0;
+        _app->setHeadless(true);
+        DrawNotifier::instance()->state.disable();
+        DrawOverlayNotifier::instance()->state.disable();
+        _app->onInit();
+        uint64_t start = Clock::nanoseconds();
+        uint64_t next = start;
+        uint64_t limit = (uint64_t)(seconds * 1e9);
+        unsigned long frame = 0;
+        while((frames == 0 || frame < frames) && (limit == 0 || Clock::nanoseconds() - start < limit)) {
+            _app->onUpdate();
+            frame++;
+            if(_intervalMillis > 0) {
+                next += (uint64_t)_intervalMillis * 1000000;
+                uint64_t now = Clock::nanoseconds();
+                if(next > now) {
+                    struct timespec ts;
+                    ts.tv_sec = (time_t)((next - now) / 1000000000);
+                    ts.tv_nsec = (long)((next - now) % 1000000000);
+                    nanosleep(&ts, 0);
+                }
+            }
+        }
+        double elapsed = (Clock::nanoseconds() - start) * 1e-9;
+        std::ostringstream os;
+        os << "[cg::Manager] headless: " << frame << " frames in " << elapsed << " s ("
+           << (elapsed > 0 ? frame / elapsed : 0) << " fps)";
+        DebugFile::instance()->writeLine(os.str());
+#ifdef CG_PROFILE
+        Profiler::instance()->dump();
+#endif
+        _app->shutdown();
+        delete _app;
+        cleanup();
     }
 	void Manager::shutdownApp() {
 		_app->shutdown();
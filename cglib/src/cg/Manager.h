@@ -37,6 +37,14 @@ namespace cg {
 	 *  Reshape events are dispatched to cg::ReshapeEventNotifier.
 	 *  cg::Application::update is called at the frame rate.
 	 *  cg::Application::display is called after each update.
+	 *  In headless mode (cg::Manager::runAppHeadless, or runApp with the
+	 *  property HEADLESS = 1) no GLUT window is created: the update step is
+	 *  driven in a loop, at the frame rate or as fast as possible if it is 0,
+	 *  for a number of frames and/or seconds (0 meaning no limit), and the
+	 *  draw and drawOverlay steps are disabled. The achieved frame rate is
+	 *  written to the debug file before the application is shut down.
+	 *  The properties HEADLESS_FRAMES, HEADLESS_SECONDS and HEADLESS_FPS
+	 *  configure the loop when headless mode is selected from runApp.
 	 */
     class Manager {
 
@@ -49,6 +57,7 @@ namespace cg {
     public:
         Application* getApp();
 	    void runApp(Application *app, int fps, int glut_argc, char** glut_argv);
+	    void runAppHeadless(Application *app, int fps, unsigned long frames, double seconds);
 		void shutdownApp();
         int getIntervalMillis() const;
     };
@@ -0,0 +1,296 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "Metrics.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace cg {
+
+	Metric::Metric(const std::string& name, unsigned int offset) : _name(name), _offset(offset) {
+	}
+	Metric::~Metric() {
+	}
+	const std::string& Metric::getName() const {
+		return _name;
+	}
+
+	Counter::Counter(const std::string& name, unsigned int offset) : Metric(name, offset) {
+		_value = 0;
+		_delta = 0;
+	}
+	uint64_t Counter::getValue() const {
+		return _value;
+	}
+	uint64_t Counter::getDelta() const {
+		return _delta;
+	}
+	const char* Counter::getType() const {
+		return "counter";
+	}
+	unsigned int Counter::getCellCount() const {
+		return 1;
+	}
+	void Counter::aggregate(const std::vector<MetricsThread*>& threads) {
+		uint64_t value = 0;
+		for(std::vector<MetricsThread*>::const_iterator i = threads.begin(); i != threads.end(); i++) {
+			value += load((*i)->cells + _offset);
+		}
+		_delta = value - _value;
+		_value = value;
+	}
+	void Counter::write(std::ostream& out) const {
+		out << getName() << ": " << _value << " (+" << _delta << ")";
+	}
+	void Counter::writeCsv(std::ostream& out) const {
+		out << getName() << ",counter," << _value << ",,,";
+	}
+
+	Gauge::Gauge(const std::string& name, unsigned int offset) : Metric(name, offset) {
+		_value = 0;
+	}
+	double Gauge::getValue() const {
+		return _value;
+	}
+	const char* Gauge::getType() const {
+		return "gauge";
+	}
+	unsigned int Gauge::getCellCount() const {
+		return 2;
+	}
+	void Gauge::aggregate(const std::vector<MetricsThread*>& threads) {
+		for(std::vector<MetricsThread*>::const_iterator i = threads.begin(); i != threads.end(); i++) {
+			uint64_t sequence = __atomic_load_n((*i)->cells + _offset + 1, __ATOMIC_ACQUIRE);
+			if(sequence != (*i)->seen[_offset + 1]) {
+				(*i)->seen[_offset + 1] = sequence;
+				_value = fromBits(load((*i)->cells + _offset));
+			}
+		}
+	}
+	void Gauge::write(std::ostream& out) const {
+		out << getName() << ": " << _value;
+	}
+	void Gauge::writeCsv(std::ostream& out) const {
+		out << getName() << ",gauge," << _value << ",,,";
+	}
+
+	Histogram::Histogram(const std::string& name, unsigned int offset, double min, double max, unsigned int buckets) :
+		Metric(name, offset), _counts(buckets + 2, 0) {
+		_min = min;
+		_max = max;
+		_buckets = buckets;
+		_scale = buckets / (max - min);
+		_count = 0;
+		_sum = 0;
+	}
+	double Histogram::getMin() const {
+		return _min;
+	}
+	double Histogram::getMax() const {
+		return _max;
+	}
+	unsigned int Histogram::getBucketCount() const {
+		return _buckets;
+	}
+	uint64_t Histogram::getCount() const {
+		return _count;
+	}
+	double Histogram::getMean() const {
+		return (_count == 0) ? 0 : _sum / _count;
+	}
+	double Histogram::getPercentile(double p) const {
+		if(_count == 0) {
+			return 0;
+		}
+		double rank = p / 100.0 * _count;
+		uint64_t below = 0;
+		for(unsigned int b = 0; b < _buckets + 2; b++) {
+			if(_counts[b] > 0 && below + _counts[b] >= rank) {
+				if(b == 0) {
+					return _min;
+				} else if(b == _buckets + 1) {
+					return _max;
+				}
+				double fraction = (rank - below) / _counts[b];
+				return _min + (b - 1 + fraction) / _scale;
+			}
+			below += _counts[b];
+		}
+		return _max;
+	}
+	const char* Histogram::getType() const {
+		return "histogram";
+	}
+	unsigned int Histogram::getCellCount() const {
+		return _buckets + 3;
+	}
+	void Histogram::aggregate(const std::vector<MetricsThread*>& threads) {
+		std::fill(_counts.begin(), _counts.end(), 0);
+		_count = 0;
+		_sum = 0;
+		for(std::vector<MetricsThread*>::const_iterator i = threads.begin(); i != threads.end(); i++) {
+			const uint64_t* cells = (*i)->cells + _offset;
+			for(unsigned int b = 0; b < _buckets + 2; b++) {
+				uint64_t count = load(cells + b);
+				_counts[b] += count;
+				_count += count;
+			}
+			_sum += fromBits(load(cells + _buckets + 2));
+		}
+	}
+	void Histogram::write(std::ostream& out) const {
+		out << getName() << ": n " << _count << " mean " << getMean()
+			<< " p50 " << getPercentile(50) << " p99 " << getPercentile(99);
+	}
+	void Histogram::writeCsv(std::ostream& out) const {
+		out << getName() << ",histogram," << getMean() << "," << _count << ","
+			<< getPercentile(50) << "," << getPercentile(99);
+	}
+
+	Metrics* Metrics::_instance = 0;
+
+	Metrics::Metrics() {
+		pthread_key_create(&_key, 0);
+		pthread_mutex_init(&_mutex, 0);
+		_cellCount = 0;
+	}
+	Metrics::~Metrics() {
+		for(std::vector<Metric*>::iterator i = _metrics.begin(); i != _metrics.end(); i++) {
+			delete (*i);
+		}
+		for(std::vector<MetricsThread*>::iterator i = _threads.begin(); i != _threads.end(); i++) {
+			delete [] (*i)->cells;
+			delete [] (*i)->seen;
+			delete (*i);
+		}
+		pthread_key_delete(_key);
+		pthread_mutex_destroy(&_mutex);
+	}
+	void Metrics::cleanup() {
+		delete _instance;
+		_instance = 0;
+	}
+	uint64_t* Metrics::registerThread() {
+		MetricsThread* thread = new MetricsThread();
+		thread->cells = new uint64_t[MAX_CELLS]();
+		thread->seen = new uint64_t[MAX_CELLS]();
+		pthread_mutex_lock(&_mutex);
+		_threads.push_back(thread);
+		pthread_mutex_unlock(&_mutex);
+		pthread_setspecific(_key, thread->cells);
+		return thread->cells;
+	}
+	unsigned int Metrics::allocateCells(const std::string& name, unsigned int count) {
+		if(_cellCount + count > MAX_CELLS) {
+			throw std::runtime_error("[cg::Metrics] no cells left for metric '" + name + "'.");
+		}
+		unsigned int offset = _cellCount;
+		_cellCount += count;
+		return offset;
+	}
+	Metric* Metrics::find(const std::string& name, const char* type) {
+		std::map<std::string, Metric*>::iterator i = _index.find(name);
+		if(i == _index.end()) {
+			return 0;
+		}
+		if(std::string(i->second->getType()) != type) {
+			throw std::runtime_error("[cg::Metrics] metric '" + name + "' is not a " + type + ".");
+		}
+		return i->second;
+	}
+	Counter* Metrics::getCounter(const std::string& name) {
+		pthread_mutex_lock(&_mutex);
+		Counter* counter = 0;
+		try {
+			counter = (Counter*)find(name, "counter");
+			if(counter == 0) {
+				counter = new Counter(name, allocateCells(name, 1));
+				_metrics.push_back(counter);
+				_index[name] = counter;
+			}
+		} catch(std::runtime_error& e) {
+			pthread_mutex_unlock(&_mutex);
+			throw e;
+		}
+		pthread_mutex_unlock(&_mutex);
+		return counter;
+	}
+	Gauge* Metrics::getGauge(const std::string& name) {
+		pthread_mutex_lock(&_mutex);
+		Gauge* gauge = 0;
+		try {
+			gauge = (Gauge*)find(name, "gauge");
+			if(gauge == 0) {
+				gauge = new Gauge(name, allocateCells(name, 2));
+				_metrics.push_back(gauge);
+				_index[name] = gauge;
+			}
+		} catch(std::runtime_error& e) {
+			pthread_mutex_unlock(&_mutex);
+			throw e;
+		}
+		pthread_mutex_unlock(&_mutex);
+		return gauge;
+	}
+	Histogram* Metrics::getHistogram(const std::string& name, double min, double max, unsigned int buckets) {
+		if(!(min < max) || buckets == 0) {
+			throw std::runtime_error("[cg::Metrics] histogram '" + name + "' needs min < max and at least one bucket.");
+		}
+		pthread_mutex_lock(&_mutex);
+		Histogram* histogram = 0;
+		try {
+			histogram = (Histogram*)find(name, "histogram");
+			if(histogram == 0) {
+				histogram = new Histogram(name, allocateCells(name, buckets + 3), min, max, buckets);
+				_metrics.push_back(histogram);
+				_index[name] = histogram;
+			}
+		} catch(std::runtime_error& e) {
+			pthread_mutex_unlock(&_mutex);
+			throw e;
+		}
+		pthread_mutex_unlock(&_mutex);
+		return histogram;
+	}
+	const std::vector<Metric*>& Metrics::getAllMetrics() const {
+		return _metrics;
+	}
+	void Metrics::aggregate() {
+		pthread_mutex_lock(&_mutex);
+		for(std::vector<Metric*>::iterator i = _metrics.begin(); i != _metrics.end(); i++) {
+			(*i)->aggregate(_threads);
+		}
+		pthread_mutex_unlock(&_mutex);
+	}
+	void Metrics::writeCsv(std::ostream& out) {
+		out << "name,type,value,count,p50,p99" << std::endl;
+		pthread_mutex_lock(&_mutex);
+		for(std::vector<Metric*>::iterator i = _metrics.begin(); i != _metrics.end(); i++) {
+			(*i)->writeCsv(out);
+			out << std::endl;
+		}
+		pthread_mutex_unlock(&_mutex);
+	}
+	void Metrics::writeCsv(const std::string& filename) {
+		std::ofstream file(filename.c_str());
+		if(file.fail()) {
+			throw std::runtime_error("[cg::Metrics] cannot open '" + filename + "'.");
+		}
+		writeCsv(file);
+	}
+}
@@ -0,0 +1,224 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <map>
+#include <ostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace cg {
+
+	/** cg::MetricsThread holds the cells one thread updates its metrics in,
+	 *  and what cg::Metrics::aggregate last saw of them.
+	 */
+	struct MetricsThread {
+		uint64_t* cells;
+		uint64_t* seen;
+	};
+
+	/** cg::Metric is the base of the named metrics of cg::Metrics. Each
+	 *  metric owns a range of cells in every thread's cg::MetricsThread;
+	 *  updates write the calling thread's cells only, and
+	 *  cg::Metric::aggregate folds all threads into a snapshot that the
+	 *  getters, the overlay and the CSV dump read.
+	 */
+	class Metric {
+	private:
+		std::string _name;
+	protected:
+		unsigned int _offset;
+		static void store(uint64_t* cell, uint64_t value) {
+			__atomic_store_n(cell, value, __ATOMIC_RELAXED);
+		}
+		static uint64_t load(const uint64_t* cell) {
+			return __atomic_load_n(cell, __ATOMIC_RELAXED);
+		}
+		static uint64_t toBits(double value) {
+			uint64_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+		static double fromBits(uint64_t bits) {
+			double value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+		uint64_t* getCells() const;
+	public:
+		Metric(const std::string& name, unsigned int offset);
+		virtual ~Metric();
+		const std::string& getName() const;
+		virtual const char* getType() const = 0;
+		virtual unsigned int getCellCount() const = 0;
+		virtual void aggregate(const std::vector<MetricsThread*>& threads) = 0;
+		virtual void write(std::ostream& out) const = 0;
+		virtual void writeCsv(std::ostream& out) const = 0;
+	};
+
+	/** cg::Counter is a monotonically increasing count. getValue is the
+	 *  total, getDelta its increase over the last aggregated frame.
+	 */
+	class Counter : public Metric {
+	private:
+		uint64_t _value, _delta;
+	public:
+		Counter(const std::string& name, unsigned int offset);
+		void add(uint64_t n = 1) {
+			uint64_t* cell = getCells() + _offset;
+			store(cell, *cell + n);
+		}
+		uint64_t getValue() const;
+		uint64_t getDelta() const;
+		const char* getType() const;
+		unsigned int getCellCount() const;
+		void aggregate(const std::vector<MetricsThread*>& threads);
+		void write(std::ostream& out) const;
+		void writeCsv(std::ostream& out) const;
+	};
+
+	/** cg::Gauge is a value that is set rather than accumulated; the
+	 *  snapshot holds the last value set by any thread.
+	 */
+	class Gauge : public Metric {
+	private:
+		double _value;
+	public:
+		Gauge(const std::string& name, unsigned int offset);
+		void set(double value) {
+			uint64_t* cells = getCells() + _offset;
+			store(cells, toBits(value));
+			// the sequence number tells aggregate that this thread has set a new value
+			__atomic_store_n(cells + 1, cells[1] + 1, __ATOMIC_RELEASE);
+		}
+		double getValue() const;
+		const char* getType() const;
+		unsigned int getCellCount() const;
+		void aggregate(const std::vector<MetricsThread*>& threads);
+		void write(std::ostream& out) const;
+		void writeCsv(std::ostream& out) const;
+	};
+
+	/** cg::Histogram counts samples in equal-width buckets over [min, max),
+	 *  plus one bucket below and one above; percentiles are interpolated
+	 *  within a bucket.
+	 */
+	class Histogram : public Metric {
+	private:
+		double _min, _max, _scale;
+		unsigned int _buckets;
+		std::vector<uint64_t> _counts;
+		uint64_t _count;
+		double _sum;
+	public:
+		Histogram(const std::string& name, unsigned int offset, double min, double max, unsigned int buckets);
+		void add(double sample) {
+			uint64_t* cells = getCells() + _offset;
+			unsigned int bucket;
+			if(sample < _min) {
+				bucket = 0;
+			} else if(sample >= _max) {
+				bucket = _buckets + 1;
+			} else {
+				bucket = 1 + (unsigned int)((sample - _min) * _scale);
+			}
+			store(cells + bucket, cells[bucket] + 1);
+			store(cells + _buckets + 2, toBits(fromBits(cells[_buckets + 2]) + sample));
+		}
+		double getMin() const;
+		double getMax() const;
+		unsigned int getBucketCount() const;
+		uint64_t getCount() const;
+		double getMean() const;
+		double getPercentile(double p) const;
+		const char* getType() const;
+		unsigned int getCellCount() const;
+		void aggregate(const std::vector<MetricsThread*>& threads);
+		void write(std::ostream& out) const;
+		void writeCsv(std::ostream& out) const;
+	};
+
+	/** cg::Metrics is a singleton registry of named cg::Counter, cg::Gauge
+	 *  and cg::Histogram metrics, cheap enough to update from the frame
+	 *  loop: an update is a few plain stores into cells private to the
+	 *  calling thread, with neither locks nor atomic read-modify-writes.
+	 *  cg::Application calls cg::Metrics::aggregate once per frame, after
+	 *  the update phase, to fold all threads into the snapshots. Metrics
+	 *  are looked up by name once and the returned pointers kept; they
+	 *  live until cg::Metrics::cleanup. cg::MetricsOverlay displays the
+	 *  snapshots, and cg::Metrics::writeCsv dumps them.
+	 */
+	class Metrics {
+
+	public:
+		static const unsigned int MAX_CELLS = 4096;
+
+	private:
+		static Metrics* _instance;
+		Metrics();
+
+		pthread_key_t _key;
+		pthread_mutex_t _mutex;
+		std::vector<MetricsThread*> _threads;
+		std::vector<Metric*> _metrics;
+		std::map<std::string, Metric*> _index;
+		unsigned int _cellCount;
+
+		uint64_t* registerThread();
+		unsigned int allocateCells(const std::string& name, unsigned int count);
+		Metric* find(const std::string& name, const char* type);
+
+	public:
+		static Metrics* instance();
+		virtual ~Metrics();
+		void cleanup();
+
+		Counter* getCounter(const std::string& name);
+		Gauge* getGauge(const std::string& name);
+		Histogram* getHistogram(const std::string& name, double min, double max, unsigned int buckets);
+		const std::vector<Metric*>& getAllMetrics() const;
+
+		uint64_t* getCells();
+		void aggregate();
+		void writeCsv(std::ostream& out);
+		void writeCsv(const std::string& filename);
+	};
+
+	inline Metrics* Metrics::instance() {
+		if (_instance == 0) {
+			_instance = new Metrics();
+		}
+		return _instance;
+	}
+	inline uint64_t* Metrics::getCells() {
+		uint64_t* cells = (uint64_t*)pthread_getspecific(_key);
+		if(cells == 0) {
+			cells = registerThread();
+		}
+		return cells;
+	}
+	inline uint64_t* Metric::getCells() const {
+		return Metrics::instance()->getCells();
+	}
+}
+
+#endif // METRICS_H
@@ -0,0 +1,41 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "MetricsOverlay.h"
+#include <sstream>
+#include "Util.h"
+
+namespace cg {
+
+	MetricsOverlay::MetricsOverlay() : Entity("MetricsOverlay") {
+	}
+	MetricsOverlay::~MetricsOverlay() {
+	}
+	void MetricsOverlay::init() {
+	}
+	void MetricsOverlay::drawOverlay() {
+		const std::vector<Metric*>& metrics = Metrics::instance()->getAllMetrics();
+		_lines.clear();
+		for(std::vector<Metric*>::const_iterator i = metrics.begin(); i != metrics.end(); i++) {
+			std::ostringstream line;
+			(*i)->write(line);
+			_lines.push_back(line.str());
+		}
+		glColor3d(0.2, 0.9, 0.9);
+		Util::instance()->drawBitmapStringVector(_lines, 10, 10 + 12.0 * _lines.size(), -12);
+	}
+}
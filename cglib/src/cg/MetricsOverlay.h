@@ -0,0 +1,47 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef METRICS_OVERLAY_H
+#define METRICS_OVERLAY_H
+
+#include <string>
+#include <vector>
+#include "Entity.h"
+#include "IDrawOverlayListener.h"
+#include "Metrics.h"
+
+namespace cg {
+
+	/** cg::MetricsOverlay is an entity listing the cg::Metrics snapshots
+	 *  on screen, in registration order, from the bottom left corner.
+	 *  cg::Application adds it when METRICS_OVERLAY is set in the
+	 *  application properties.
+	 */
+	class MetricsOverlay : public Entity, public IDrawOverlayListener {
+
+	private:
+		std::vector<std::string> _lines;
+
+	public:
+		MetricsOverlay();
+		~MetricsOverlay();
+		void init();
+		void drawOverlay();
+	};
+}
+
+#endif // METRICS_OVERLAY_H
@@ -21,17 +21,78 @@
 
 #include <fstream>
 #include "DebugFile.h"
+#include "DispatchList.h"
 #include "Entity.h"
 #include "LockableOrderedMap.h"
 #include "State.h"
+#include "Tracer.h"
+#ifdef CG_PROFILE
+#include "Clock.h"
+#include "Profiler.h"
+#endif
 
 #define FOR_EACH_LISTENER(COMMAND)\
 	try {\
 		lock();\
 		if(state.isEnabled()) {\
-			for (tListenerIterator i = _listeners.begin(); i != _listeners.end(); i++) {\
-				if((*i)->entity->state.isEnabled()) {\
-					(*i)->listener->COMMAND;\
+			refreshDispatch();\
+			tDispatchEntry* dispatch_end = _dispatch.end();\
+			for (tDispatchEntry* i = _dispatch.begin(); i != dispatch_end; i++) {\
+				if(i->state->isEnabled()) {\
+					i->listener->COMMAND;\
+				}\
+			}\
+		}\
+		unlock();\
+	} catch(std::runtime_error& e) {\
+		cg::DebugFile::instance()->writeException(e);\
+		throw e;\
+	}
+
+/** CALL_LISTENER_PROFILED(COMMAND, PHASE) calls COMMAND on the listener of
+ *  dispatch entry i. If CG_PROFILE is defined, the duration of the callback
+ *  is also added to the cg::ProfileSeries of the listener for PHASE; the
+ *  series is looked up again after each rebuild of the dispatch list.
+ *  These macros are only expanded in the notifiers compiled in cglib, and
+ *  the types shared with the application (cg::DispatchEntry,
+ *  cg::ComponentStore) have the same layout either way, so CG_PROFILE only
+ *  needs to be defined when building cglib. Defining it in the application
+ *  as well is harmless.
+ */
+#ifdef CG_PROFILE
+#define CALL_LISTENER_PROFILED(COMMAND, PHASE)\
+	if(i->profile == 0) {\
+		i->profile = cg::Profiler::instance()->getSeries(PHASE, i->entity->getId());\
+	}\
+	uint64_t profile_start = cg::Clock::nanoseconds();\
+	i->listener->COMMAND;\
+	i->profile->add(cg::Clock::nanoseconds() - profile_start);
+#else
+#define CALL_LISTENER_PROFILED(COMMAND, PHASE) i->listener->COMMAND;
+#endif
+
+/** FOR_EACH_LISTENER_PROFILED(COMMAND, PHASE) is FOR_EACH_LISTENER(COMMAND)
+ *  with each callback going through CALL_LISTENER_PROFILED, and, while
+ *  cg::Tracer::isTracingEntities, traced as a scope named by the entity id.
+ */
+#define FOR_EACH_LISTENER_PROFILED(COMMAND, PHASE)\
+	try {\
+		lock();\
+		if(state.isEnabled()) {\
+			refreshDispatch();\
+			bool trace_entities = cg::Tracer::instance()->isTracingEntities();\
+			tDispatchEntry* dispatch_end = _dispatch.end();\
+			for (tDispatchEntry* i = _dispatch.begin(); i != dispatch_end; i++) {\
+				if(i->state->isEnabled()) {\
+					if(trace_entities) {\
+						if(i->traceName == 0) {\
+							i->traceName = cg::Tracer::getNameId(i->entity->getId());\
+						}\
+						cg::TraceScope trace_scope(i->traceName);\
+						CALL_LISTENER_PROFILED(COMMAND, PHASE)\
+					} else {\
+						CALL_LISTENER_PROFILED(COMMAND, PHASE)\
+					}\
 				}\
 			}\
 		}\
@@ -43,7 +104,8 @@
 
 #define DUMP_METHOD(CLASS)\
 	void dump() {\
-		std::ofstream& file = DebugFile::instance()->getOutputFileStream();\
+		cg::DebugFileLock debug_file_lock;\
+		std::ofstream& file = debug_file_lock.getOutputFileStream();\
 		file << CLASS::instance()->state << " " << #CLASS << " (" << size() << ")" << std::endl;\
 		for (tListenerIterator i = _listeners.begin(); i != _listeners.end(); i++) {\
 			file << "    " << (*i)->entity->state << " " << (*i)->entity->getId() << std::endl;\
@@ -77,12 +139,18 @@ namespace cg {
 	 *  It is usually a better design to create a 'manager' class that deals with
 	 *  the dynamic addition/removal of related entities. This manager class can be
 	 *  registered instead of its inner classes, and be an entry point for them.
+	 *  Callbacks are dispatched from a cg::DispatchList<E>, a flat copy of the
+	 *  listener and entity state pointers that is rebuilt only when the set
+	 *  of listeners has changed since the previous dispatch.
 	 */
 	template <class E>
 	class Notifier {
 	protected:
 		LockableOrderedMap<ListenerInfo<E> > _listeners;
 		typedef typename LockableOrderedMap<ListenerInfo<E> >::iterator tListenerIterator;
+		DispatchList<E> _dispatch;
+		typedef DispatchEntry<E> tDispatchEntry;
+		void refreshDispatch();
 
 		Notifier();
 		virtual ~Notifier();
@@ -134,7 +202,12 @@ namespace cg {
 		} else {
 			std::string id = entity->getId();
 			ListenerInfo<E>* info = new ListenerInfo<E>(listener, entity);
-			_listeners.add(id,info);
+			try {
+				_listeners.add(id,info);
+			} catch(std::runtime_error&) {
+				delete info;
+				throw;
+			}
 		}
 	}
 	template<class E>
@@ -146,6 +219,16 @@ namespace cg {
 		_listeners.destroyAll();
 	}
 	template<class E>
+	inline
+	void Notifier<E>::refreshDispatch() {
+		if(!_dispatch.isCurrent(_listeners.getVersion())) {
+			_dispatch.reset(_listeners.getVersion());
+			for (tListenerIterator i = _listeners.begin(); i != _listeners.end(); i++) {
+				_dispatch.add((*i)->listener, (*i)->entity);
+			}
+		}
+	}
+	template<class E>
 	void Notifier<E>::lock() {
 		_listeners.lock();
 	}
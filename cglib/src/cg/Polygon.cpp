@@ -0,0 +1,326 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "Polygon.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CG_POLYGON_X86
+#endif
+
+namespace cg {
+
+	// Edge data, one entry per edge:
+	// - crossing test: _edge0.._edge4 = min y, max y, x0, y0 and dx/dy, for
+	//   the non-horizontal edges only (horizontal edges are never crossed);
+	// - convex polygons: _edge0.._edge2 = a, b, c, with a*x + b*y + c >= 0
+	//   on the inner side of the edge.
+	Polygon::Polygon() {
+		_box[0] = _box[1] = _box[2] = _box[3] = 0;
+		_isConvex = false;
+	}
+	Polygon::Polygon(const std::vector<Vector2d>& vertices) {
+		set(vertices);
+	}
+	Polygon::~Polygon() {
+	}
+	bool Polygon::checkConvex(const std::vector<Vector2d>& vertices) {
+		// Convex iff every turn has the same sign and the edge directions
+		// change sign at most twice on each axis (rules out star shapes)
+		unsigned int n = vertices.size();
+		if(n < 3) {
+			return false;
+		}
+		double turn = 0;
+		int sign[2] = { 0, 0 }, first[2] = { 0, 0 }, flips[2] = { 0, 0 };
+		for(unsigned int i = 0; i < n; i++) {
+			const Vector2d& p0 = vertices[i];
+			const Vector2d& p1 = vertices[(i + 1) % n];
+			const Vector2d& p2 = vertices[(i + 2) % n];
+			double d[2] = { p2[0] - p1[0], p2[1] - p1[1] };
+			for(int k = 0; k < 2; k++) {
+				int s = (d[k] > 0) - (d[k] < 0);
+				if(s != 0) {
+					if(sign[k] == 0) {
+						first[k] = s;
+					} else if(s != sign[k]) {
+						flips[k]++;
+					}
+					sign[k] = s;
+				}
+			}
+			double w = (p1[0] - p0[0]) * d[1] - (p1[1] - p0[1]) * d[0];
+			if(w != 0) {
+				if(turn == 0) {
+					turn = w;
+				} else if((w > 0) != (turn > 0)) {
+					return false;
+				}
+			}
+		}
+		for(int k = 0; k < 2; k++) {
+			if(sign[k] != first[k]) {
+				flips[k]++;
+			}
+		}
+		if(turn == 0 || flips[0] > 2 || flips[1] > 2) {
+			return false;
+		}
+		double orientation = turn > 0 ? 1 : -1;
+		for(unsigned int i = 0; i < n; i++) {
+			const Vector2d& p = vertices[i];
+			const Vector2d& q = vertices[(i + 1) % n];
+			double a = -(q[1] - p[1]) * orientation;
+			double b = (q[0] - p[0]) * orientation;
+			_edge0.push_back(a);
+			_edge1.push_back(b);
+			_edge2.push_back(-(a * p[0] + b * p[1]));
+		}
+		return true;
+	}
+	void Polygon::set(const std::vector<Vector2d>& vertices) {
+		_edge0.clear();
+		_edge1.clear();
+		_edge2.clear();
+		_edge3.clear();
+		_edge4.clear();
+		_box[0] = _box[1] = _box[2] = _box[3] = 0;
+		if(vertices.empty()) {
+			_isConvex = false;
+			return;
+		}
+		_box[0] = _box[2] = vertices[0][0];
+		_box[1] = _box[3] = vertices[0][1];
+		for(unsigned int i = 1; i < vertices.size(); i++) {
+			_box[0] = std::min(_box[0], (float)vertices[i][0]);
+			_box[1] = std::min(_box[1], (float)vertices[i][1]);
+			_box[2] = std::max(_box[2], (float)vertices[i][0]);
+			_box[3] = std::max(_box[3], (float)vertices[i][1]);
+		}
+		_isConvex = checkConvex(vertices);
+		if(_isConvex) {
+			return;
+		}
+		for(unsigned int i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+			double xi = vertices[i][0], yi = vertices[i][1];
+			double xj = vertices[j][0], yj = vertices[j][1];
+			if(yi != yj) {
+				_edge0.push_back(std::min(yi, yj));
+				_edge1.push_back(std::max(yi, yj));
+				_edge2.push_back(xi);
+				_edge3.push_back(yi);
+				_edge4.push_back((xj - xi) / (yj - yi));
+			}
+		}
+	}
+	unsigned int Polygon::getEdgeCount() const {
+		return _edge0.size();
+	}
+	bool Polygon::isConvex() const {
+		return _isConvex;
+	}
+	bool Polygon::contains(float x, float y) const {
+		if(x < _box[0] || y < _box[1] || x > _box[2] || y > _box[3]) {
+			return false;
+		}
+		unsigned int n = _edge0.size();
+		if(_isConvex) {
+			for(unsigned int e = 0; e < n; e++) {
+				if(_edge0[e] * x + _edge1[e] * y + _edge2[e] < 0) {
+					return false;
+				}
+			}
+			return n > 0;
+		}
+		bool inside = false;
+		for(unsigned int e = 0; e < n; e++) {
+			if(_edge0[e] <= y && y < _edge1[e] && x < _edge4[e] * (y - _edge3[e]) + _edge2[e]) {
+				inside = !inside;
+			}
+		}
+		return inside;
+	}
+	bool Polygon::contains(const Vector2d& point) const {
+		return contains((float)point[0], (float)point[1]);
+	}
+
+	// SIMD kernels: classify the points in blocks of 32, one hit word per
+	// block, and return the index of the first point left for the scalar test.
+#ifdef CG_POLYGON_X86
+	__attribute__((target("sse2")))
+	static unsigned int containsSSE2(const float* const edges[5], unsigned int edge_count, bool convex,
+			const float box[4], const float* xs, const float* ys, unsigned int n, uint32_t* hits) {
+		const __m128 minX = _mm_set1_ps(box[0]);
+		const __m128 minY = _mm_set1_ps(box[1]);
+		const __m128 maxX = _mm_set1_ps(box[2]);
+		const __m128 maxY = _mm_set1_ps(box[3]);
+		unsigned int i = 0;
+		for(; i + 32 <= n; i += 32) {
+			uint32_t mask = 0;
+			for(unsigned int j = 0; j < 32; j += 4) {
+				__m128 x = _mm_loadu_ps(xs + i + j);
+				__m128 y = _mm_loadu_ps(ys + i + j);
+				__m128 inBox = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(minX, x), _mm_cmple_ps(x, maxX)),
+										  _mm_and_ps(_mm_cmple_ps(minY, y), _mm_cmple_ps(y, maxY)));
+				if(_mm_movemask_ps(inBox) == 0) {
+					continue;
+				}
+				__m128 inside = inBox;
+				if(convex) {
+					for(unsigned int e = 0; e < edge_count; e++) {
+						__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[0][e]), x),
+								_mm_mul_ps(_mm_set1_ps(edges[1][e]), y)), _mm_set1_ps(edges[2][e]));
+						inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+					}
+				} else {
+					__m128 parity = _mm_setzero_ps();
+					for(unsigned int e = 0; e < edge_count; e++) {
+						__m128 span = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(edges[0][e]), y),
+												 _mm_cmplt_ps(y, _mm_set1_ps(edges[1][e])));
+						__m128 cross = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[4][e]),
+								_mm_sub_ps(y, _mm_set1_ps(edges[3][e]))), _mm_set1_ps(edges[2][e]));
+						parity = _mm_xor_ps(parity, _mm_and_ps(span, _mm_cmplt_ps(x, cross)));
+					}
+					inside = _mm_and_ps(inside, parity);
+				}
+				mask |= (uint32_t)_mm_movemask_ps(inside) << j;
+			}
+			hits[i / 32] = mask;
+		}
+		return i;
+	}
+	__attribute__((target("avx")))
+	static unsigned int containsAVX(const float* const edges[5], unsigned int edge_count, bool convex,
+			const float box[4], const float* xs, const float* ys, unsigned int n, uint32_t* hits) {
+		const __m256 minX = _mm256_set1_ps(box[0]);
+		const __m256 minY = _mm256_set1_ps(box[1]);
+		const __m256 maxX = _mm256_set1_ps(box[2]);
+		const __m256 maxY = _mm256_set1_ps(box[3]);
+		unsigned int i = 0;
+		for(; i + 32 <= n; i += 32) {
+			uint32_t mask = 0;
+			for(unsigned int j = 0; j < 32; j += 8) {
+				__m256 x = _mm256_loadu_ps(xs + i + j);
+				__m256 y = _mm256_loadu_ps(ys + i + j);
+				__m256 inBox = _mm256_and_ps(
+					_mm256_and_ps(_mm256_cmp_ps(minX, x, _CMP_LE_OQ), _mm256_cmp_ps(x, maxX, _CMP_LE_OQ)),
+					_mm256_and_ps(_mm256_cmp_ps(minY, y, _CMP_LE_OQ), _mm256_cmp_ps(y, maxY, _CMP_LE_OQ)));
+				if(_mm256_movemask_ps(inBox) == 0) {
+					continue;
+				}
+				__m256 inside = inBox;
+				if(convex) {
+					for(unsigned int e = 0; e < edge_count; e++) {
+						__m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[0][e]), x),
+								_mm256_mul_ps(_mm256_set1_ps(edges[1][e]), y)), _mm256_set1_ps(edges[2][e]));
+						inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+					}
+				} else {
+					__m256 parity = _mm256_setzero_ps();
+					for(unsigned int e = 0; e < edge_count; e++) {
+						__m256 span = _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(edges[0][e]), y, _CMP_LE_OQ),
+													_mm256_cmp_ps(y, _mm256_set1_ps(edges[1][e]), _CMP_LT_OQ));
+						__m256 cross = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[4][e]),
+								_mm256_sub_ps(y, _mm256_set1_ps(edges[3][e]))), _mm256_set1_ps(edges[2][e]));
+						parity = _mm256_xor_ps(parity, _mm256_and_ps(span, _mm256_cmp_ps(x, cross, _CMP_LT_OQ)));
+					}
+					inside = _mm256_and_ps(inside, parity);
+				}
+				mask |= (uint32_t)_mm256_movemask_ps(inside) << j;
+			}
+			hits[i / 32] = mask;
+		}
+		return i;
+	}
+#endif
+	typedef unsigned int (*tContainsKernel)(const float* const edges[5], unsigned int edge_count, bool convex,
+			const float box[4], const float* xs, const float* ys, unsigned int n, uint32_t* hits);
+
+	typedef struct {
+		const char* name;
+		tContainsKernel kernel;
+	} tContainsKernelEntry;
+
+	// The kernels the CPU supports, slowest first; the scalar kernel is 0.
+	static std::vector<tContainsKernelEntry> supportedContainsKernels() {
+		std::vector<tContainsKernelEntry> kernels;
+		tContainsKernelEntry scalar = { "scalar", 0 };
+		kernels.push_back(scalar);
+#ifdef CG_POLYGON_X86
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("sse2")) {
+			tContainsKernelEntry sse2 = { "sse2", containsSSE2 };
+			kernels.push_back(sse2);
+		}
+		if(__builtin_cpu_supports("avx")) {
+			tContainsKernelEntry avx = { "avx", containsAVX };
+			kernels.push_back(avx);
+		}
+#endif
+		return kernels;
+	}
+	static tContainsKernel& getContainsKernel() {
+		static tContainsKernel kernel = supportedContainsKernels().back().kernel;
+		return kernel;
+	}
+	// Sets bit i%32 of hits[i/32] if point (xs[i], ys[i]) is inside the
+	// polygon ((n+31)/32 words are written) and returns the number of
+	// points inside.
+	unsigned int Polygon::contains(const float* xs, const float* ys, unsigned int n, uint32_t* hits) const {
+		tContainsKernel kernel = getContainsKernel();
+		unsigned int i = 0;
+		if(kernel && !_edge0.empty()) {
+			const float* const edges[5] = { &_edge0[0], &_edge1[0], &_edge2[0],
+				_isConvex ? 0 : &_edge3[0], _isConvex ? 0 : &_edge4[0] };
+			i = kernel(edges, _edge0.size(), _isConvex, _box, xs, ys, n, hits);
+		}
+		for(; i < n; i++) {
+			if(i % 32 == 0) {
+				hits[i / 32] = 0;
+			}
+			if(contains(xs[i], ys[i])) {
+				hits[i / 32] |= 1u << (i % 32);
+			}
+		}
+		unsigned int count = 0;
+		for(unsigned int w = 0; w < (n + 31) / 32; w++) {
+			count += __builtin_popcount(hits[w]);
+		}
+		return count;
+	}
+	// Names of the batch kernels the CPU supports, slowest first.
+	std::vector<std::string> Polygon::getContainsKernels() {
+		std::vector<tContainsKernelEntry> kernels = supportedContainsKernels();
+		std::vector<std::string> names;
+		for(unsigned int i = 0; i < kernels.size(); i++) {
+			names.push_back(kernels[i].name);
+		}
+		return names;
+	}
+	// Selects the batch kernel by name, and returns false if the CPU does
+	// not support it. Not to be called while other threads classify points.
+	bool Polygon::setContainsKernel(const std::string& name) {
+		std::vector<tContainsKernelEntry> kernels = supportedContainsKernels();
+		for(unsigned int i = 0; i < kernels.size(); i++) {
+			if(name == kernels[i].name) {
+				getContainsKernel() = kernels[i].kernel;
+				return true;
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,66 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef POLYGON_H
+#define POLYGON_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Vector.h"
+
+namespace cg {
+
+	/** cg::Polygon precomputes the edge data of a polygon once, so that many
+	 *  points can be classified against it per frame, e.g. projectiles against
+	 *  an asteroid outline. It uses the same crossing test as
+	 *  cg::Util::isPointInPolygon, or, if the polygon is convex, one half-plane
+	 *  test per edge. cg::Polygon::contains on arrays of points classifies them
+	 *  with the widest SIMD instructions the CPU supports, skipping groups of
+	 *  points outside the bounding box; cg::Polygon::setContainsKernel
+	 *  selects another of the kernels listed by getContainsKernels.
+	 *  Edge data is kept in single precision, so points (almost) on the
+	 *  boundary may be classified differently from cg::Util::isPointInPolygon.
+	 */
+	class Polygon {
+
+	private:
+		std::vector<float> _edge0, _edge1, _edge2, _edge3, _edge4;
+		float _box[4];
+		bool _isConvex;
+
+		bool checkConvex(const std::vector<Vector2d>& vertices);
+
+	public:
+		Polygon();
+		Polygon(const std::vector<Vector2d>& vertices);
+		~Polygon();
+
+		void set(const std::vector<Vector2d>& vertices);
+		unsigned int getEdgeCount() const;
+		bool isConvex() const;
+		bool contains(float x, float y) const;
+		bool contains(const Vector2d& point) const;
+		unsigned int contains(const float* xs, const float* ys, unsigned int n, uint32_t* hits) const;
+
+		static std::vector<std::string> getContainsKernels();
+		static bool setContainsKernel(const std::string& name);
+	};
+
+}
+
+#endif // POLYGON_H
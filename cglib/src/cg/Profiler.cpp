@@ -0,0 +1,109 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "Profiler.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace cg {
+
+	ProfileSeries::ProfileSeries(const std::string& phase, const std::string& id) : _phase(phase), _id(id) {
+		_next = 0;
+		_count = 0;
+	}
+	ProfileSeries::~ProfileSeries() {
+	}
+	const std::string& ProfileSeries::getPhase() const {
+		return _phase;
+	}
+	const std::string& ProfileSeries::getId() const {
+		return _id;
+	}
+	unsigned int ProfileSeries::getCount() const {
+		return _count;
+	}
+	double ProfileSeries::getMin() const {
+		if(_count == 0) {
+			return 0;
+		}
+		uint64_t min = *std::min_element(_samples, _samples + _count);
+		return min * 1e-6;
+	}
+	double ProfileSeries::getAverage() const {
+		if(_count == 0) {
+			return 0;
+		}
+		uint64_t sum = 0;
+		for(unsigned int i = 0; i < _count; i++) {
+			sum += _samples[i];
+		}
+		return sum * 1e-6 / _count;
+	}
+	double ProfileSeries::getPercentile(double p) const {
+		if(_count == 0) {
+			return 0;
+		}
+		std::vector<uint64_t> sorted(_samples, _samples + _count);
+		unsigned int rank = (unsigned int)(p / 100.0 * (_count - 1) + 0.5);
+		std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+		return sorted[rank] * 1e-6;
+	}
+
+    Profiler* Profiler::_instance = 0;
+
+    Profiler* Profiler::instance() {
+        if (_instance == 0) {
+			_instance = new Profiler();
+		}
+        return _instance;
+	}
+    Profiler::Profiler() {
+	}
+    Profiler::~Profiler() {
+		for(std::vector<ProfileSeries*>::iterator i = _series.begin(); i != _series.end(); i++) {
+			delete (*i);
+		}
+	}
+    void Profiler::cleanup() {
+		delete _instance;
+		_instance = 0;
+	}
+	ProfileSeries* Profiler::getSeries(const std::string& phase, const std::string& id) {
+		std::string key = phase + "/" + id;
+		std::map<std::string, ProfileSeries*>::iterator i = _index.find(key);
+		if(i != _index.end()) {
+			return i->second;
+		}
+		ProfileSeries* series = new ProfileSeries(phase, id);
+		_series.push_back(series);
+		_index[key] = series;
+		return series;
+	}
+	const std::vector<ProfileSeries*>& Profiler::getAllSeries() const {
+		return _series;
+	}
+	void Profiler::dump() {
+		DebugFileLock debug_file_lock;
+		std::ofstream& file = debug_file_lock.getOutputFileStream();
+		file << "[Profiler] (" << _series.size() << ") min/avg/p99 ms over the last " << ProfileSeries::WINDOW << " calls" << std::endl;
+		for(std::vector<ProfileSeries*>::iterator i = _series.begin(); i != _series.end(); i++) {
+			file << "    " << (*i)->getPhase() << " " << (*i)->getId() << std::fixed << std::setprecision(3)
+				<< " " << (*i)->getMin() << " " << (*i)->getAverage() << " " << (*i)->getPercentile(99) << std::endl;
+			file.unsetf(std::ios::floatfield);
+		}
+	}
+}
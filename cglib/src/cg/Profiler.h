@@ -0,0 +1,89 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "DebugFile.h"
+
+namespace cg {
+
+	/** cg::ProfileSeries keeps the last WINDOW durations of one listener
+	 *  callback, and computes rolling statistics over them in milliseconds.
+	 */
+	class ProfileSeries {
+
+	public:
+		static const unsigned int WINDOW = 128;
+
+	private:
+		std::string _phase, _id;
+		uint64_t _samples[WINDOW];
+		unsigned int _next, _count;
+
+	public:
+		ProfileSeries(const std::string& phase, const std::string& id);
+		~ProfileSeries();
+
+		const std::string& getPhase() const;
+		const std::string& getId() const;
+		void add(uint64_t nanos) {
+			_samples[_next] = nanos;
+			_next = (_next + 1) % WINDOW;
+			if(_count < WINDOW) {
+				_count++;
+			}
+		}
+		unsigned int getCount() const;
+		double getMin() const;
+		double getAverage() const;
+		double getPercentile(double p) const;
+	};
+
+	/** cg::Profiler is a singleton owning one cg::ProfileSeries per profiled
+	 *  (phase, entity) pair. It is fed by cg::UpdateNotifier,
+	 *  cg::DrawNotifier and cg::DrawOverlayNotifier, with one sample per
+	 *  callback, when cglib is compiled with CG_PROFILE defined. Otherwise
+	 *  the notifiers are not instrumented and the profiler stays empty.
+	 *  cg::Profiler::dump writes the statistics to the cg::DebugFile, and
+	 *  cg::ProfilerOverlay displays them on screen.
+	 */
+	class Profiler {
+
+	private:
+		static Profiler* _instance;
+		Profiler();
+
+		std::vector<ProfileSeries*> _series;
+		std::map<std::string, ProfileSeries*> _index;
+
+	public:
+		static Profiler* instance();
+		virtual ~Profiler();
+		void cleanup();
+
+		ProfileSeries* getSeries(const std::string& phase, const std::string& id);
+		const std::vector<ProfileSeries*>& getAllSeries() const;
+		void dump();
+	};
+}
+
+#endif // PROFILER_H
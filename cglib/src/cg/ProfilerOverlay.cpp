@@ -0,0 +1,52 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "ProfilerOverlay.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "Manager.h"
+#include "Util.h"
+
+namespace cg {
+
+	static bool slowerAverage(const ProfileSeries* a, const ProfileSeries* b) {
+		return a->getAverage() > b->getAverage();
+	}
+
+	ProfilerOverlay::ProfilerOverlay() : Entity("ProfilerOverlay") {
+	}
+	ProfilerOverlay::~ProfilerOverlay() {
+	}
+	void ProfilerOverlay::init() {
+	}
+	void ProfilerOverlay::drawOverlay() {
+		std::vector<ProfileSeries*> series = Profiler::instance()->getAllSeries();
+		std::sort(series.begin(), series.end(), slowerAverage);
+		_lines.clear();
+		_lines.push_back("phase / entity: min avg p99 (ms)");
+		for(std::vector<ProfileSeries*>::iterator i = series.begin(); i != series.end(); i++) {
+			std::ostringstream line;
+			line << (*i)->getPhase() << " / " << (*i)->getId() << ": " << std::fixed << std::setprecision(3)
+				<< (*i)->getMin() << " " << (*i)->getAverage() << " " << (*i)->getPercentile(99);
+			_lines.push_back(line.str());
+		}
+		double top = Manager::instance()->getApp()->getWindow().height - 15.0;
+		glColor3d(0.9, 0.9, 0.2);
+		Util::instance()->drawBitmapStringVector(_lines, 10, top, -12);
+	}
+}
@@ -0,0 +1,46 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef PROFILER_OVERLAY_H
+#define PROFILER_OVERLAY_H
+
+#include <string>
+#include <vector>
+#include "Entity.h"
+#include "IDrawOverlayListener.h"
+#include "Profiler.h"
+
+namespace cg {
+
+	/** cg::ProfilerOverlay is an entity listing the cg::Profiler statistics
+	 *  on screen, slowest average first. cg::Application adds it
+	 *  automatically when cglib is compiled with CG_PROFILE defined.
+	 */
+	class ProfilerOverlay : public Entity, public IDrawOverlayListener {
+
+	private:
+		std::vector<std::string> _lines;
+
+	public:
+		ProfilerOverlay();
+		~ProfilerOverlay();
+		void init();
+		void drawOverlay();
+	};
+}
+
+#endif // PROFILER_OVERLAY_H
@@ -17,127 +17,513 @@
 // Copyright 2007 Carlos Martinho
 
 #include "Properties.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include "DebugFile.h"
 
 namespace cg {
 
 	const char Properties::COMMENT = '#';
 
-	SINGLETON_IMPLEMENTATION(Properties)
+	Properties* Properties::_instance = 0;
 
-	void Properties::parseLine(const std::string& line) {
-		std::string name, value, separator;
-		std::istringstream iss(line);
-		if(line.size() > 0) {
-			iss >> name >> separator;
-			if(name[0] == COMMENT) {
-				return;
-			}
-			value = iss.str().substr(iss.tellg());
-			if(separator == "=") {
-				size_t start = value.find_first_not_of(" ");
-				size_t end = value.find_last_not_of(" ");
-				std::pair<tPropertyIterator,bool> result =
-					_properties.insert( std::make_pair(name,value.substr(start,end-start+1)) );
-				if(result.second == 0) {
-					throw std::runtime_error("[cg::Properties] property '" + name + "' already exists.");
+	Properties* Properties::instance() {
+		if (_instance == 0) {
+			_instance = new Properties();
+		}
+		return _instance;
+	}
+	Properties::Properties() {
+		_watchFd = -1;
+	}
+	Properties::~Properties() {
+		unwatch();
+	}
+	void Properties::cleanup() {
+		delete _instance;
+		_instance = 0;
+	}
+	/** A line of a properties file, as slices of the file buffer.
+	 */
+	typedef struct {
+		const char *name, *nameEnd, *value, *valueEnd;
+	} tPropertyLine;
+
+	/** The whole contents of a file, read in one buffer. The file is not
+	 *  mapped: an editor may truncate it while it is being reloaded, which
+	 *  would raise SIGBUS on a mapping but only shortens a read.
+	 */
+	class FileBuffer {
+	private:
+		std::vector<char> _data;
+	public:
+		FileBuffer(const std::string& filename) {
+			int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+			struct stat st;
+			if(fd < 0 || fstat(fd, &st) != 0) {
+				if(fd >= 0) {
+					close(fd);
+				}
+				throw std::runtime_error("[cg::Properties] Cannot open file '" + filename + "'.");
+			}
+			// one byte more than the size, so that a file that grew is read to its end
+			_data.resize((size_t)st.st_size + 1);
+			size_t size = 0;
+			for(;;) {
+				if(size == _data.size()) {
+					_data.resize(2 * size);
+				}
+				ssize_t length = ::read(fd, &_data[size], _data.size() - size);
+				if(length > 0) {
+					size += (size_t)length;
+				} else if(length == 0) {
+					break;
+				} else if(errno != EINTR) {
+					close(fd);
+					throw std::runtime_error("[cg::Properties] Cannot read file '" + filename + "'.");
 				}
 			}
+			close(fd);
+			_data.resize(size);
+		}
+		const char* begin() const {
+			return _data.empty() ? 0 : &_data[0];
+		}
+		const char* end() const {
+			return begin() + _data.size();
+		}
+	};
+
+	static inline bool isBlank(char c) {
+		return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+	}
+
+	// Splits the file in place into the (name, value) slices of its property
+	// lines, with the syntax of the original line by line parser: the first
+	// two blank separated tokens are the name and the separator, which must
+	// be '=', and the value is the rest of the line without surrounding spaces.
+	static void tokenize(const char* p, const char* end, std::vector<tPropertyLine>& lines) {
+		while(p < end) {
+			const char* line_end = (const char*)memchr(p, '\n', end - p);
+			if(line_end == 0) {
+				line_end = end;
+			}
+			const char* q = p;
+			while(q < line_end && isBlank(*q)) {
+				q++;
+			}
+			tPropertyLine line;
+			line.name = q;
+			while(q < line_end && !isBlank(*q)) {
+				q++;
+			}
+			line.nameEnd = q;
+			while(q < line_end && isBlank(*q)) {
+				q++;
+			}
+			const char* separator = q;
+			while(q < line_end && !isBlank(*q)) {
+				q++;
+			}
+			if(line.name < line.nameEnd && *line.name != '#' && q - separator == 1 && *separator == '=') {
+				while(q < line_end && *q == ' ') {
+					q++;
+				}
+				const char* value_end = line_end;
+				while(value_end > q && value_end[-1] == ' ') {
+					value_end--;
+				}
+				line.value = q;
+				line.valueEnd = value_end;
+				lines.push_back(line);
+			}
+			p = line_end + 1;
+		}
+	}
+
+	void Properties::read(const std::string& filename, std::map<std::string,std::string>& properties) {
+		FileBuffer file(filename);
+		std::vector<tPropertyLine> lines;
+		tokenize(file.begin(), file.end(), lines);
+		std::string name;
+		for(std::vector<tPropertyLine>::iterator i = lines.begin(); i != lines.end(); i++) {
+			name.assign(i->name, i->nameEnd);
+			std::map<std::string,std::string>::iterator p = properties.lower_bound(name);
+			if(p != properties.end() && p->first == name) {
+				throw std::runtime_error("[cg::Properties] property '" + name + "' already exists.");
+			}
+			p = properties.insert(p, std::map<std::string,std::string>::value_type(name, std::string()));
+			p->second.assign(i->value, i->valueEnd);
 		}
 	}
 	void Properties::load(const std::string& filename) {
-		std::string line;
-		std::ifstream file;
-		file.open(filename.c_str());
-		if(file.is_open()) {
-			while (!file.eof()) {
-				std::getline(file,line);
-				parseLine(line);
-			}
-			file.close();
-		} else {
-			throw std::runtime_error("[cg::Properties] Cannot open file '" + filename + "'.");
+		FileBuffer file(filename);
+		std::vector<tPropertyLine> lines;
+		tokenize(file.begin(), file.end(), lines);
+		// keys are inserted straight into the map, and removed again if a duplicate is found
+		std::vector<tPropertyIterator> inserted;
+		inserted.reserve(lines.size());
+		std::string name;
+		for(std::vector<tPropertyLine>::iterator i = lines.begin(); i != lines.end(); i++) {
+			name.assign(i->name, i->nameEnd);
+			tPropertyIterator p = _properties.lower_bound(name);
+			if(p != _properties.end() && p->first == name) {
+				for(std::vector<tPropertyIterator>::iterator j = inserted.begin(); j != inserted.end(); j++) {
+					_properties.erase(*j);
+				}
+				throw std::runtime_error("[cg::Properties] property '" + name + "' already exists.");
+			}
+			p = _properties.insert(p, std::map<std::string,PropertyEntry>::value_type(name, PropertyEntry()));
+			p->second.value.assign(i->value, i->valueEnd);
+			p->second.version = 1;
+			inserted.push_back(p);
 		}
+		_filename = filename;
 	}
 	bool Properties::exists(const std::string& name) {
 		tPropertyIterator i = _properties.find(name);
 		return (i != _properties.end());
 	}
-	int Properties::getInt(const std::string& name) {
-		std::string s = getString(name);
-		std::istringstream iss(s);
-		int i;
-		if(iss >> i) {
-			return i;
+	const PropertyEntry* Properties::getEntry(const std::string& name) {
+		tPropertyIterator i = _properties.find(name);
+		if( i != _properties.end() ) {
+			return &i->second;
 		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <int> (value '"+ s +"').");
+			throw std::runtime_error("[cg::Properties] unknown property '" + name + "'.");
 		}
 	}
-	float Properties::getFloat(const std::string& name) {
-		std::string s = getString(name);
-		std::istringstream iss(s);
-		float f;
-		if (iss >> f) {
-			return f;
-		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <double> (value '"+ s +"').");
+
+	// strtol/strtod based, with the syntax of the extraction operators they
+	// replace: leading blanks are skipped and whatever follows the number is
+	// ignored, so "0x1A" reads as 0.
+	static bool parseNumber(const char*& p, int& value) {
+		char* end;
+		errno = 0;
+		long l = strtol(p, &end, 10);
+		if(end == p || errno == ERANGE || l < INT_MIN || l > INT_MAX) {
+			return false;
 		}
- 	}
-	double Properties::getDouble(const std::string& name) {
-		std::string s = getString(name);
-		std::istringstream iss(s);
-		double d;
-		if (iss >> d) {
-			return d;
-		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <double> (value '"+ s +"').");
+		value = (int)l;
+		p = end;
+		return true;
+	}
+	static inline bool isDigit(char c) {
+		return c >= '0' && c <= '9';
+	}
+	// Returns the end of the decimal number at p, or 0 if there is none.
+	// Unlike strtod, there is no hexadecimal, infinity or nan, and an
+	// exponent must have digits.
+	static const char* scanDecimal(const char* p) {
+		if(*p == '+' || *p == '-') {
+			p++;
 		}
- 	}
-	std::string Properties::getString(const std::string& name) {
-		tPropertyIterator i = _properties.find(name);
-		if( i != _properties.end() ) {
-			return i->second;
-		} else {
-			throw std::runtime_error("[cg::Properties] unknown property '" + name + "'.");
+		const char* digits = p;
+		while(isDigit(*p)) {
+			p++;
+		}
+		bool has_digits = (p != digits);
+		if(*p == '.') {
+			digits = ++p;
+			while(isDigit(*p)) {
+				p++;
+			}
+			has_digits = has_digits || (p != digits);
 		}
+		if(!has_digits) {
+			return 0;
+		}
+		if(*p == 'e' || *p == 'E') {
+			p++;
+			if(*p == '+' || *p == '-') {
+				p++;
+			}
+			digits = p;
+			while(isDigit(*p)) {
+				p++;
+			}
+			if(p == digits) {
+				return 0;
+			}
+		}
+		return p;
 	}
-	Vector2i Properties::getVector2i(const std::string& name) {
-		std::string s = getString(name);
-		std::istringstream iss(s);
-		int v0, v1;
-		if(iss >> v0 >> v1) {
-			return Vector2i(v0,v1);
+	static inline void convert(const char* s, float& value) {
+		value = strtof(s, 0);
+	}
+	static inline void convert(const char* s, double& value) {
+		value = strtod(s, 0);
+	}
+	// The scanned text is converted from a copy, where strtod cannot read
+	// past it. Underflow is accepted, as by the extraction operators, and
+	// overflow rejected.
+	template<class T>
+	static bool parseReal(const char*& p, T& value) {
+		while(isBlank(*p)) {
+			p++;
+		}
+		const char* end = scanDecimal(p);
+		if(end == 0) {
+			return false;
+		}
+		char buffer[64];
+		std::string text;
+		const char* s = buffer;
+		size_t length = end - p;
+		if(length < sizeof(buffer)) {
+			memcpy(buffer, p, length);
+			buffer[length] = 0;
 		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <Vector2i> (value '"+ s +"').");
+			text.assign(p, end);
+			s = text.c_str();
+		}
+		errno = 0;
+		convert(s, value);
+		if(errno == ERANGE && fabs(value) > 1) {
+			return false;
 		}
+		p = end;
+		return true;
 	}
-	Vector2d Properties::getVector2d(const std::string& name) {
-		std::string s = getString(name);
-		std::istringstream iss(s);
+	static bool parseNumber(const char*& p, float& value) {
+		return parseReal(p, value);
+	}
+	static bool parseNumber(const char*& p, double& value) {
+		return parseReal(p, value);
+	}
+
+	bool Properties::parse(const std::string& s, int& value) {
+		const char* p = s.c_str();
+		return parseNumber(p, value);
+	}
+	bool Properties::parse(const std::string& s, float& value) {
+		const char* p = s.c_str();
+		return parseNumber(p, value);
+	}
+	bool Properties::parse(const std::string& s, double& value) {
+		const char* p = s.c_str();
+		return parseNumber(p, value);
+	}
+	bool Properties::parse(const std::string& s, std::string& value) {
+		value = s;
+		return true;
+	}
+	bool Properties::parse(const std::string& s, Vector2d& value) {
+		const char* p = s.c_str();
 		double v0, v1;
-		if(iss >> v0 >> v1) {
-			return Vector2d(v0,v1);
-		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <Vector2d> (value '"+ s +"').");
+		if(parseNumber(p, v0) && parseNumber(p, v1)) {
+			value = Vector2d(v0,v1);
+			return true;
 		}
+		return false;
 	}
-	Vector3i Properties::getVector3i(const std::string& name) {
-		std::string s = getString(name);
-		std::istringstream iss(s);
+	bool Properties::parse(const std::string& s, Vector2i& value) {
+		const char* p = s.c_str();
+		int v0, v1;
+		if(parseNumber(p, v0) && parseNumber(p, v1)) {
+			value = Vector2i(v0,v1);
+			return true;
+		}
+		return false;
+	}
+	bool Properties::parse(const std::string& s, Vector3d& value) {
+		const char* p = s.c_str();
+		double v0, v1, v2;
+		if(parseNumber(p, v0) && parseNumber(p, v1) && parseNumber(p, v2)) {
+			value = Vector3d(v0,v1,v2);
+			return true;
+		}
+		return false;
+	}
+	bool Properties::parse(const std::string& s, Vector3i& value) {
+		const char* p = s.c_str();
 		int v0, v1, v2;
-		if(iss >> v0 >> v1 >> v2) {
-			return Vector3i(v0,v1,v2);
-		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <Vector3i> (value '"+ s +"').");
+		if(parseNumber(p, v0) && parseNumber(p, v1) && parseNumber(p, v2)) {
+			value = Vector3i(v0,v1,v2);
+			return true;
 		}
+		return false;
 	}
-	Vector3d Properties::getVector3d(const std::string& name) {
+	const char* Properties::getTypeName(const int&) {
+		return "int";
+	}
+	const char* Properties::getTypeName(const float&) {
+		return "float";
+	}
+	const char* Properties::getTypeName(const double&) {
+		return "double";
+	}
+	const char* Properties::getTypeName(const std::string&) {
+		return "string";
+	}
+	const char* Properties::getTypeName(const Vector2d&) {
+		return "Vector2d";
+	}
+	const char* Properties::getTypeName(const Vector2i&) {
+		return "Vector2i";
+	}
+	const char* Properties::getTypeName(const Vector3d&) {
+		return "Vector3d";
+	}
+	const char* Properties::getTypeName(const Vector3i&) {
+		return "Vector3i";
+	}
+	void Properties::reportInvalid(const std::string& name, const std::string& value, const char* type) {
+		DebugFile::instance()->writeLine(DebugFile::LEVEL_WARNING, "[cg::Properties] Cannot convert property '" +
+			name + "' to <" + type + "> (value '" + value + "'), keeping the previous value.");
+	}
+
+	template<class T>
+	T Properties::get(const std::string& name) {
 		std::string s = getString(name);
-		std::istringstream iss(s);
-		double v0, v1, v2;
-		if(iss >> v0 >> v1 >> v2) {
-			return Vector3d(v0,v1,v2);
+		T value;
+		if(parse(s, value)) {
+			return value;
 		} else {
-			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <Vector3d> (value '"+ s +"').");
+			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <" +
+				getTypeName(value) + "> (value '"+ s +"').");
+		}
+	}
+	int Properties::getInt(const std::string& name) {
+		return get<int>(name);
+	}
+	float Properties::getFloat(const std::string& name) {
+		return get<float>(name);
+ 	}
+	double Properties::getDouble(const std::string& name) {
+		return get<double>(name);
+ 	}
+	std::string Properties::getString(const std::string& name) {
+		return getEntry(name)->value;
+	}
+	Vector2i Properties::getVector2i(const std::string& name) {
+		return get<Vector2i>(name);
+	}
+	Vector2d Properties::getVector2d(const std::string& name) {
+		return get<Vector2d>(name);
+	}
+	Vector3i Properties::getVector3i(const std::string& name) {
+		return get<Vector3i>(name);
+	}
+	Vector3d Properties::getVector3d(const std::string& name) {
+		return get<Vector3d>(name);
+	}
+
+	void Properties::reload() {
+		if(_filename.empty()) {
+			throw std::runtime_error("[cg::Properties] no file loaded to reload.");
+		}
+		std::map<std::string,std::string> properties;
+		read(_filename, properties);
+		std::vector<std::string> changed;
+		for(std::map<std::string,std::string>::iterator i = properties.begin(); i != properties.end(); i++) {
+			tPropertyIterator p = _properties.find(i->first);
+			if(p == _properties.end()) {
+				PropertyEntry& entry = _properties[i->first];
+				entry.value = i->second;
+				entry.version = 1;
+				changed.push_back(i->first);
+			} else if(p->second.value != i->second) {
+				p->second.value = i->second;
+				p->second.version++;
+				changed.push_back(i->first);
+			}
+		}
+		std::ostringstream os;
+		os << "[cg::Properties] reloaded '" << _filename << "', " << changed.size() << " changed";
+		for(std::vector<std::string>::iterator i = changed.begin(); i != changed.end(); i++) {
+			os << (i == changed.begin() ? ": " : ", ") << *i << " = " << _properties[*i].value;
+		}
+		DebugFile::instance()->writeLine(os.str());
+		for(std::vector<std::string>::iterator i = changed.begin(); i != changed.end(); i++) {
+			std::pair<tListenerIterator,tListenerIterator> range = _listeners.equal_range(*i);
+			for(tListenerIterator l = range.first; l != range.second; l++) {
+				l->second->onPropertyChanged(*i);
+			}
+		}
+	}
+	void Properties::watch() {
+		if(_watchFd >= 0) {
+			return;
+		}
+		if(_filename.empty()) {
+			throw std::runtime_error("[cg::Properties] no file loaded to watch.");
+		}
+#ifdef __linux__
+		// editors often replace the file rather than rewrite it, so the directory is watched
+		std::string::size_type slash = _filename.rfind('/');
+		std::string directory = (slash == std::string::npos) ? "." : _filename.substr(0, slash + 1);
+		_watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if(_watchFd < 0) {
+			throw std::runtime_error("[cg::Properties] cannot create an inotify instance.");
+		}
+		if(inotify_add_watch(_watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+			close(_watchFd);
+			_watchFd = -1;
+			throw std::runtime_error("[cg::Properties] cannot watch '" + directory + "'.");
+		}
+#else
+		throw std::runtime_error("[cg::Properties] watching files is only supported on Linux.");
+#endif
+	}
+	void Properties::unwatch() {
+		if(_watchFd >= 0) {
+			close(_watchFd);
+			_watchFd = -1;
+		}
+	}
+	bool Properties::isWatching() const {
+		return _watchFd >= 0;
+	}
+	bool Properties::poll() {
+		if(_watchFd < 0) {
+			return false;
+		}
+		bool modified = false;
+#ifdef __linux__
+		std::string::size_type slash = _filename.rfind('/');
+		std::string basename = (slash == std::string::npos) ? _filename : _filename.substr(slash + 1);
+		char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+		ssize_t length;
+		while((length = ::read(_watchFd, buffer, sizeof(buffer))) > 0) {
+			for(char* p = buffer; p < buffer + length; ) {
+				const struct inotify_event* event = (const struct inotify_event*)p;
+				if(event->len > 0 && basename == event->name) {
+					modified = true;
+				}
+				p += sizeof(struct inotify_event) + event->len;
+			}
+		}
+#endif
+		if(modified) {
+			try {
+				reload();
+			} catch(std::runtime_error& e) {
+				DebugFile::instance()->writeException(e);
+				return false;
+			}
+		}
+		return modified;
+	}
+	void Properties::subscribe(const std::string& name, IPropertyListener* listener) {
+		_listeners.insert(std::make_pair(name, listener));
+	}
+	void Properties::unsubscribe(IPropertyListener* listener) {
+		for(tListenerIterator i = _listeners.begin(); i != _listeners.end(); ) {
+			if(i->second == listener) {
+				_listeners.erase(i++);
+			} else {
+				i++;
+			}
 		}
 	}
 }
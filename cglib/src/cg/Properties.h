@@ -24,11 +24,20 @@
 #include <sstream>
 #include <string>
 #include <stdexcept>
+#include "IPropertyListener.h"
 #include "Singleton.h"
 #include "Vector.h"
 
 namespace cg {
 
+	/** cg::PropertyEntry is the stored value of one property, with a version
+	 *  that is increased whenever a reload changes the value.
+	 */
+	struct PropertyEntry {
+		std::string value;
+		unsigned long version;
+	};
+
 	/** cg::Properties is a singleton that maintains pairs (name, value) imported from
 	 *  a text file.
 	 *  The file format is as follows. Each property is written on a different line.
@@ -39,6 +48,18 @@ namespace cg {
 	 *  For other types, use the cg::Properties::getString method to obtain the value as
 	 *  a string and parse it.
 	 *  Lines which first non-blank character is a '#' are comments.
+	 *  Files are read whole and split in place, so that loading costs
+	 *  little more than one allocation per name and per value; numbers are
+	 *  converted with strtol and strtod. cg::Properties::read parses a file
+	 *  into a plain map, without loading it.
+	 *  The getters look the name up and parse the value on every call; code
+	 *  reading a property repeatedly should keep a cg::PropertyHandle, which
+	 *  parses it once and again only after it changed.
+	 *  After cg::Properties::watch, the file is watched with inotify, and
+	 *  cg::Properties::poll, called by cg::Application between frames,
+	 *  reloads it when it is rewritten: changed values get a new version,
+	 *  and the cg::IPropertyListener subscribed to them are notified.
+	 *  Properties removed from the file keep their last value.
 	 */
 	class Properties {
 
@@ -46,11 +67,16 @@ namespace cg {
 
 	private:
 		static const char COMMENT;
-		std::map<const std::string,const std::string> _properties;
-		typedef std::map<const std::string,const std::string>::iterator tPropertyIterator;
-		void parseLine(const std::string& line);
+		std::map<std::string,PropertyEntry> _properties;
+		typedef std::map<std::string,PropertyEntry>::iterator tPropertyIterator;
+		std::multimap<std::string,IPropertyListener*> _listeners;
+		typedef std::multimap<std::string,IPropertyListener*>::iterator tListenerIterator;
+		std::string _filename;
+		int _watchFd;
+		template<class T> T get(const std::string& name);
 
 	public:
+		static void read(const std::string& filename, std::map<std::string,std::string>& properties);
 		void load(const std::string& filename);
 		bool exists(const std::string& name);
 
@@ -63,7 +89,102 @@ namespace cg {
 		Vector2i getVector2i(const std::string& name);
 		Vector3d getVector3d(const std::string& name);
 		Vector3i getVector3i(const std::string& name);
+
+		const PropertyEntry* getEntry(const std::string& name);
+		static bool parse(const std::string& s, int& value);
+		static bool parse(const std::string& s, float& value);
+		static bool parse(const std::string& s, double& value);
+		static bool parse(const std::string& s, std::string& value);
+		static bool parse(const std::string& s, Vector2d& value);
+		static bool parse(const std::string& s, Vector2i& value);
+		static bool parse(const std::string& s, Vector3d& value);
+		static bool parse(const std::string& s, Vector3i& value);
+		static const char* getTypeName(const int&);
+		static const char* getTypeName(const float&);
+		static const char* getTypeName(const double&);
+		static const char* getTypeName(const std::string&);
+		static const char* getTypeName(const Vector2d&);
+		static const char* getTypeName(const Vector2i&);
+		static const char* getTypeName(const Vector3d&);
+		static const char* getTypeName(const Vector3i&);
+		static void reportInvalid(const std::string& name, const std::string& value, const char* type);
+
+		void reload();
+		void watch();
+		void unwatch();
+		bool isWatching() const;
+		bool poll();
+		void subscribe(const std::string& name, IPropertyListener* listener);
+		void unsubscribe(IPropertyListener* listener);
+	};
+
+	/** cg::PropertyHandle<T> is a typed reference to one property. The value
+	 *  is parsed when the handle is bound, and parsed again by
+	 *  cg::PropertyHandle<T>::get only if a reload has changed it since, so
+	 *  that get is a version comparison otherwise. Binding throws if the
+	 *  property does not exist or does not convert to T; an unconvertible
+	 *  reloaded value is reported to the cg::DebugFile, and the previous
+	 *  value is kept. T is int, float, double, std::string, Vector2d,
+	 *  Vector2i, Vector3d or Vector3i.
+	 */
+	template<class T>
+	class PropertyHandle {
+	private:
+		std::string _name;
+		const PropertyEntry* _entry;
+		mutable T _value;
+		mutable unsigned long _version;
+		void refresh() const;
+
+	public:
+		PropertyHandle() : _entry(0), _value(), _version(0) {}
+		PropertyHandle(const std::string& name) : _entry(0), _value(), _version(0) {
+			bind(name);
+		}
+		void bind(const std::string& name);
+		bool isBound() const {
+			return _entry != 0;
+		}
+		const std::string& getName() const {
+			return _name;
+		}
+		unsigned long getVersion() const {
+			return _entry->version;
+		}
+		const T& get() const {
+			if(_entry->version != _version) {
+				refresh();
+			}
+			return _value;
+		}
+		operator const T&() const {
+			return get();
+		}
 	};
+
+	template<class T>
+	void PropertyHandle<T>::bind(const std::string& name) {
+		const PropertyEntry* entry = Properties::instance()->getEntry(name);
+		T value;
+		if(!Properties::parse(entry->value, value)) {
+			throw std::runtime_error("[cg::Properties] Cannot convert property '" + name + "' to <" +
+				Properties::getTypeName(value) + "> (value '" + entry->value + "').");
+		}
+		_name = name;
+		_entry = entry;
+		_value = value;
+		_version = entry->version;
+	}
+	template<class T>
+	void PropertyHandle<T>::refresh() const {
+		T value;
+		if(Properties::parse(_entry->value, value)) {
+			_value = value;
+		} else {
+			Properties::reportInvalid(_name, _entry->value, Properties::getTypeName(value));
+		}
+		_version = _entry->version;
+	}
 }
 
 #endif // PROPERTIES_H
@@ -0,0 +1,486 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "QuaternionArray.h"
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CG_QUATERNION_X86
+#endif
+
+namespace cg {
+
+	// Polynomial approximations used by slerp, all lanes alike:
+	// acos(x) = sqrt(1-|x|) * P(|x|), mirrored for x < 0 (Abramowitz and
+	// Stegun 4.4.46, error < 2e-8), and sin(x) for x in [0,pi] as an odd
+	// Taylor polynomial of degree 11 on min(x, pi-x) (error < 6e-8).
+	static const float ACOS[8] = { 1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f,
+								   0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f };
+	static const float SIN[6] = { 1.0f, -1.0f / 6, 1.0f / 120, -1.0f / 5040, 1.0f / 362880, -1.0f / 39916800 };
+	static const float PI_F = 3.14159265358979323846f;
+	static const float SLERP_EPSILON = 1e-6f;
+
+	static inline float acosApprox(float x) {
+		float a = x < 0 ? -x : x;
+		float p = ACOS[7];
+		for(int k = 6; k >= 0; k--) {
+			p = p * a + ACOS[k];
+		}
+		float r = sqrtf(1 - a) * p;
+		return x < 0 ? PI_F - r : r;
+	}
+	static inline float sinApprox(float x) {
+		float y = x < PI_F - x ? x : PI_F - x;
+		float y2 = y * y;
+		float p = SIN[5];
+		for(int k = 4; k >= 0; k--) {
+			p = p * y2 + SIN[k];
+		}
+		return y * p;
+	}
+
+	//---<scalar>---
+
+	static void multiplyScalar(const float* const a[4], const float* const b[4], float* const r[4],
+			unsigned int begin, unsigned int n) {
+		for(unsigned int i = begin; i < n; i++) {
+			float ax = a[0][i], ay = a[1][i], az = a[2][i], aw = a[3][i];
+			float bx = b[0][i], by = b[1][i], bz = b[2][i], bw = b[3][i];
+			r[3][i] = aw * bw - ax * bx - ay * by - az * bz;
+			r[0][i] = aw * bx + ax * bw + ay * bz - az * by;
+			r[1][i] = aw * by + ay * bw + az * bx - ax * bz;
+			r[2][i] = aw * bz + az * bw + ax * by - ay * bx;
+		}
+	}
+	static void slerpScalar(const float* const a[4], const float* const b[4], float t, float* const r[4],
+			unsigned int begin, unsigned int n) {
+		for(unsigned int i = begin; i < n; i++) {
+			float d = a[0][i] * b[0][i] + a[1][i] * b[1][i] + a[2][i] * b[2][i] + a[3][i] * b[3][i];
+			float sign = 1;
+			if(d < 0) {
+				d = -d;
+				sign = -1;
+			}
+			d = d > 1 ? 1 : d;
+			float angle = acosApprox(d);
+			float s = sinApprox(angle);
+			float k0 = 1 - t, k1 = t, inv = 1;
+			if(s >= SLERP_EPSILON) {
+				k0 = sinApprox((1 - t) * angle);
+				k1 = sinApprox(t * angle);
+				inv = 1 / s;
+			}
+			k1 *= sign;
+			for(int c = 0; c < 4; c++) {
+				r[c][i] = (a[c][i] * k0 + b[c][i] * k1) * inv;
+			}
+		}
+	}
+	static void matricesScalar(const float* const q[4], float* matrices, bool gl, unsigned int begin, unsigned int n) {
+		for(unsigned int i = begin; i < n; i++) {
+			float x = q[0][i], y = q[1][i], z = q[2][i], w = q[3][i];
+			float xx = x * x, xy = x * y, xz = x * z, xw = x * w;
+			float yy = y * y, yz = y * z, yw = y * w;
+			float zz = z * z, zw = z * w;
+			float m[9] = { 1 - 2 * (yy + zz), 2 * (xy + zw), 2 * (xz - yw),
+						   2 * (xy - zw), 1 - 2 * (xx + zz), 2 * (yz + xw),
+						   2 * (xz + yw), 2 * (yz - xw), 1 - 2 * (xx + yy) };
+			if(gl) {
+				float* out = matrices + 16 * i;
+				for(int c = 0; c < 3; c++) {
+					out[4 * c] = m[3 * c];
+					out[4 * c + 1] = m[3 * c + 1];
+					out[4 * c + 2] = m[3 * c + 2];
+					out[4 * c + 3] = 0;
+				}
+				out[12] = out[13] = out[14] = 0;
+				out[15] = 1;
+			} else {
+				for(int k = 0; k < 9; k++) {
+					matrices[9 * i + k] = m[k];
+				}
+			}
+		}
+	}
+
+#ifdef CG_QUATERNION_X86
+
+	//---<sse2>---
+
+	__attribute__((target("sse2")))
+	static inline __m128 acosSSE2(__m128 x) {
+		__m128 a = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+		__m128 p = _mm_set1_ps(ACOS[7]);
+		for(int k = 6; k >= 0; k--) {
+			p = _mm_add_ps(_mm_mul_ps(p, a), _mm_set1_ps(ACOS[k]));
+		}
+		__m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1), a)), p);
+		__m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+		return _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(PI_F), r)), _mm_andnot_ps(negative, r));
+	}
+	__attribute__((target("sse2")))
+	static inline __m128 sinSSE2(__m128 x) {
+		__m128 y = _mm_min_ps(x, _mm_sub_ps(_mm_set1_ps(PI_F), x));
+		__m128 y2 = _mm_mul_ps(y, y);
+		__m128 p = _mm_set1_ps(SIN[5]);
+		for(int k = 4; k >= 0; k--) {
+			p = _mm_add_ps(_mm_mul_ps(p, y2), _mm_set1_ps(SIN[k]));
+		}
+		return _mm_mul_ps(y, p);
+	}
+	__attribute__((target("sse2")))
+	static void multiplySSE2(const float* const a[4], const float* const b[4], float* const r[4],
+			unsigned int begin, unsigned int n) {
+		unsigned int i = begin;
+		for(; i + 4 <= n; i += 4) {
+			__m128 ax = _mm_loadu_ps(a[0] + i), ay = _mm_loadu_ps(a[1] + i), az = _mm_loadu_ps(a[2] + i), aw = _mm_loadu_ps(a[3] + i);
+			__m128 bx = _mm_loadu_ps(b[0] + i), by = _mm_loadu_ps(b[1] + i), bz = _mm_loadu_ps(b[2] + i), bw = _mm_loadu_ps(b[3] + i);
+			__m128 w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(aw, bw), _mm_mul_ps(ax, bx)), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+			__m128 x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bx), _mm_mul_ps(ax, bw)), _mm_mul_ps(ay, bz)), _mm_mul_ps(az, by));
+			__m128 y = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, by), _mm_mul_ps(ay, bw)), _mm_mul_ps(az, bx)), _mm_mul_ps(ax, bz));
+			__m128 z = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bz), _mm_mul_ps(az, bw)), _mm_mul_ps(ax, by)), _mm_mul_ps(ay, bx));
+			_mm_storeu_ps(r[0] + i, x);
+			_mm_storeu_ps(r[1] + i, y);
+			_mm_storeu_ps(r[2] + i, z);
+			_mm_storeu_ps(r[3] + i, w);
+		}
+		multiplyScalar(a, b, r, i, n);
+	}
+	__attribute__((target("sse2")))
+	static void slerpSSE2(const float* const a[4], const float* const b[4], float t, float* const r[4],
+			unsigned int begin, unsigned int n) {
+		const __m128 vt = _mm_set1_ps(t), vt1 = _mm_set1_ps(1 - t);
+		unsigned int i = begin;
+		for(; i + 4 <= n; i += 4) {
+			__m128 va[4], vb[4];
+			__m128 d = _mm_setzero_ps();
+			for(int c = 0; c < 4; c++) {
+				va[c] = _mm_loadu_ps(a[c] + i);
+				vb[c] = _mm_loadu_ps(b[c] + i);
+				d = _mm_add_ps(d, _mm_mul_ps(va[c], vb[c]));
+			}
+			__m128 sign = _mm_and_ps(_mm_cmplt_ps(d, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+			d = _mm_min_ps(_mm_set1_ps(1), _mm_xor_ps(d, sign));
+			__m128 angle = acosSSE2(d);
+			__m128 s = sinSSE2(angle);
+			__m128 linear = _mm_cmplt_ps(s, _mm_set1_ps(SLERP_EPSILON));
+			__m128 k0 = _mm_or_ps(_mm_and_ps(linear, vt1), _mm_andnot_ps(linear, sinSSE2(_mm_mul_ps(vt1, angle))));
+			__m128 k1 = _mm_or_ps(_mm_and_ps(linear, vt), _mm_andnot_ps(linear, sinSSE2(_mm_mul_ps(vt, angle))));
+			k1 = _mm_xor_ps(k1, sign);
+			__m128 inv = _mm_or_ps(_mm_and_ps(linear, _mm_set1_ps(1)), _mm_andnot_ps(linear, _mm_div_ps(_mm_set1_ps(1), s)));
+			for(int c = 0; c < 4; c++) {
+				_mm_storeu_ps(r[c] + i, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(va[c], k0), _mm_mul_ps(vb[c], k1)), inv));
+			}
+		}
+		slerpScalar(a, b, t, r, i, n);
+	}
+	// Computes the 9 rotation matrix entries of 4 quaternions, column-major.
+	__attribute__((target("sse2")))
+	static inline void matrixSSE2(__m128 x, __m128 y, __m128 z, __m128 w, __m128 m[9]) {
+		const __m128 one = _mm_set1_ps(1), two = _mm_set1_ps(2);
+		__m128 xx = _mm_mul_ps(x, x), xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), xw = _mm_mul_ps(x, w);
+		__m128 yy = _mm_mul_ps(y, y), yz = _mm_mul_ps(y, z), yw = _mm_mul_ps(y, w);
+		__m128 zz = _mm_mul_ps(z, z), zw = _mm_mul_ps(z, w);
+		m[0] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+		m[1] = _mm_mul_ps(two, _mm_add_ps(xy, zw));
+		m[2] = _mm_mul_ps(two, _mm_sub_ps(xz, yw));
+		m[3] = _mm_mul_ps(two, _mm_sub_ps(xy, zw));
+		m[4] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+		m[5] = _mm_mul_ps(two, _mm_add_ps(yz, xw));
+		m[6] = _mm_mul_ps(two, _mm_add_ps(xz, yw));
+		m[7] = _mm_mul_ps(two, _mm_sub_ps(yz, xw));
+		m[8] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+	}
+	// Stores the matrices of 4 quaternions: 4x4 through a transpose of each
+	// column, 3x3 through a buffer, as 9 floats do not fit whole vectors.
+	__attribute__((target("sse2")))
+	static inline void storeMatricesSSE2(__m128 m[9], float* matrices, bool gl, unsigned int i) {
+		if(gl) {
+			for(int c = 0; c < 4; c++) {
+				__m128 r0 = c < 3 ? m[3 * c] : _mm_setzero_ps();
+				__m128 r1 = c < 3 ? m[3 * c + 1] : _mm_setzero_ps();
+				__m128 r2 = c < 3 ? m[3 * c + 2] : _mm_setzero_ps();
+				__m128 r3 = c < 3 ? _mm_setzero_ps() : _mm_set1_ps(1);
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				_mm_storeu_ps(matrices + 16 * i + 4 * c, r0);
+				_mm_storeu_ps(matrices + 16 * (i + 1) + 4 * c, r1);
+				_mm_storeu_ps(matrices + 16 * (i + 2) + 4 * c, r2);
+				_mm_storeu_ps(matrices + 16 * (i + 3) + 4 * c, r3);
+			}
+		} else {
+			float buffer[9][4];
+			for(int k = 0; k < 9; k++) {
+				_mm_storeu_ps(buffer[k], m[k]);
+			}
+			for(int j = 0; j < 4; j++) {
+				for(int k = 0; k < 9; k++) {
+					matrices[9 * (i + j) + k] = buffer[k][j];
+				}
+			}
+		}
+	}
+	__attribute__((target("sse2")))
+	static void matricesSSE2(const float* const q[4], float* matrices, bool gl, unsigned int begin, unsigned int n) {
+		unsigned int i = begin;
+		for(; i + 4 <= n; i += 4) {
+			__m128 m[9];
+			matrixSSE2(_mm_loadu_ps(q[0] + i), _mm_loadu_ps(q[1] + i), _mm_loadu_ps(q[2] + i), _mm_loadu_ps(q[3] + i), m);
+			storeMatricesSSE2(m, matrices, gl, i);
+		}
+		matricesScalar(q, matrices, gl, i, n);
+	}
+
+	//---<avx>---
+
+	__attribute__((target("avx")))
+	static inline __m256 acosAVX(__m256 x) {
+		__m256 a = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+		__m256 p = _mm256_set1_ps(ACOS[7]);
+		for(int k = 6; k >= 0; k--) {
+			p = _mm256_add_ps(_mm256_mul_ps(p, a), _mm256_set1_ps(ACOS[k]));
+		}
+		__m256 r = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(1), a)), p);
+		return _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI_F), r), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+	}
+	__attribute__((target("avx")))
+	static inline __m256 sinAVX(__m256 x) {
+		__m256 y = _mm256_min_ps(x, _mm256_sub_ps(_mm256_set1_ps(PI_F), x));
+		__m256 y2 = _mm256_mul_ps(y, y);
+		__m256 p = _mm256_set1_ps(SIN[5]);
+		for(int k = 4; k >= 0; k--) {
+			p = _mm256_add_ps(_mm256_mul_ps(p, y2), _mm256_set1_ps(SIN[k]));
+		}
+		return _mm256_mul_ps(y, p);
+	}
+	__attribute__((target("avx")))
+	static void multiplyAVX(const float* const a[4], const float* const b[4], float* const r[4],
+			unsigned int begin, unsigned int n) {
+		unsigned int i = begin;
+		for(; i + 8 <= n; i += 8) {
+			__m256 ax = _mm256_loadu_ps(a[0] + i), ay = _mm256_loadu_ps(a[1] + i), az = _mm256_loadu_ps(a[2] + i), aw = _mm256_loadu_ps(a[3] + i);
+			__m256 bx = _mm256_loadu_ps(b[0] + i), by = _mm256_loadu_ps(b[1] + i), bz = _mm256_loadu_ps(b[2] + i), bw = _mm256_loadu_ps(b[3] + i);
+			__m256 w = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(aw, bw), _mm256_mul_ps(ax, bx)), _mm256_mul_ps(ay, by)), _mm256_mul_ps(az, bz));
+			__m256 x = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, bx), _mm256_mul_ps(ax, bw)), _mm256_mul_ps(ay, bz)), _mm256_mul_ps(az, by));
+			__m256 y = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, by), _mm256_mul_ps(ay, bw)), _mm256_mul_ps(az, bx)), _mm256_mul_ps(ax, bz));
+			__m256 z = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, bz), _mm256_mul_ps(az, bw)), _mm256_mul_ps(ax, by)), _mm256_mul_ps(ay, bx));
+			_mm256_storeu_ps(r[0] + i, x);
+			_mm256_storeu_ps(r[1] + i, y);
+			_mm256_storeu_ps(r[2] + i, z);
+			_mm256_storeu_ps(r[3] + i, w);
+		}
+		multiplyScalar(a, b, r, i, n);
+	}
+	__attribute__((target("avx")))
+	static void slerpAVX(const float* const a[4], const float* const b[4], float t, float* const r[4],
+			unsigned int begin, unsigned int n) {
+		const __m256 vt = _mm256_set1_ps(t), vt1 = _mm256_set1_ps(1 - t);
+		unsigned int i = begin;
+		for(; i + 8 <= n; i += 8) {
+			__m256 va[4], vb[4];
+			__m256 d = _mm256_setzero_ps();
+			for(int c = 0; c < 4; c++) {
+				va[c] = _mm256_loadu_ps(a[c] + i);
+				vb[c] = _mm256_loadu_ps(b[c] + i);
+				d = _mm256_add_ps(d, _mm256_mul_ps(va[c], vb[c]));
+			}
+			__m256 sign = _mm256_and_ps(_mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.0f));
+			d = _mm256_min_ps(_mm256_set1_ps(1), _mm256_xor_ps(d, sign));
+			__m256 angle = acosAVX(d);
+			__m256 s = sinAVX(angle);
+			__m256 linear = _mm256_cmp_ps(s, _mm256_set1_ps(SLERP_EPSILON), _CMP_LT_OQ);
+			__m256 k0 = _mm256_blendv_ps(sinAVX(_mm256_mul_ps(vt1, angle)), vt1, linear);
+			__m256 k1 = _mm256_xor_ps(_mm256_blendv_ps(sinAVX(_mm256_mul_ps(vt, angle)), vt, linear), sign);
+			__m256 inv = _mm256_blendv_ps(_mm256_div_ps(_mm256_set1_ps(1), s), _mm256_set1_ps(1), linear);
+			for(int c = 0; c < 4; c++) {
+				_mm256_storeu_ps(r[c] + i, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(va[c], k0), _mm256_mul_ps(vb[c], k1)), inv));
+			}
+		}
+		slerpScalar(a, b, t, r, i, n);
+	}
+	__attribute__((target("avx")))
+	static void matricesAVX(const float* const q[4], float* matrices, bool gl, unsigned int begin, unsigned int n) {
+		unsigned int i = begin;
+		for(; i + 8 <= n; i += 8) {
+			__m256 x = _mm256_loadu_ps(q[0] + i), y = _mm256_loadu_ps(q[1] + i);
+			__m256 z = _mm256_loadu_ps(q[2] + i), w = _mm256_loadu_ps(q[3] + i);
+			const __m256 one = _mm256_set1_ps(1), two = _mm256_set1_ps(2);
+			__m256 xx = _mm256_mul_ps(x, x), xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), xw = _mm256_mul_ps(x, w);
+			__m256 yy = _mm256_mul_ps(y, y), yz = _mm256_mul_ps(y, z), yw = _mm256_mul_ps(y, w);
+			__m256 zz = _mm256_mul_ps(z, z), zw = _mm256_mul_ps(z, w);
+			__m256 m[9];
+			m[0] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz)));
+			m[1] = _mm256_mul_ps(two, _mm256_add_ps(xy, zw));
+			m[2] = _mm256_mul_ps(two, _mm256_sub_ps(xz, yw));
+			m[3] = _mm256_mul_ps(two, _mm256_sub_ps(xy, zw));
+			m[4] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz)));
+			m[5] = _mm256_mul_ps(two, _mm256_add_ps(yz, xw));
+			m[6] = _mm256_mul_ps(two, _mm256_add_ps(xz, yw));
+			m[7] = _mm256_mul_ps(two, _mm256_sub_ps(yz, xw));
+			m[8] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy)));
+			// Store each 128-bit half as 4 quaternions
+			__m128 lo[9], hi[9];
+			for(int k = 0; k < 9; k++) {
+				lo[k] = _mm256_castps256_ps128(m[k]);
+				hi[k] = _mm256_extractf128_ps(m[k], 1);
+			}
+			storeMatricesSSE2(lo, matrices, gl, i);
+			storeMatricesSSE2(hi, matrices, gl, i + 4);
+		}
+		matricesScalar(q, matrices, gl, i, n);
+	}
+#endif
+
+	//---<selection>---
+
+	typedef void (*tMultiplyKernel)(const float* const a[4], const float* const b[4], float* const r[4],
+			unsigned int begin, unsigned int n);
+	typedef void (*tSlerpKernel)(const float* const a[4], const float* const b[4], float t, float* const r[4],
+			unsigned int begin, unsigned int n);
+	typedef void (*tMatricesKernel)(const float* const q[4], float* matrices, bool gl, unsigned int begin, unsigned int n);
+
+	typedef struct {
+		const char* name;
+		tMultiplyKernel multiply;
+		tSlerpKernel slerp;
+		tMatricesKernel matrices;
+	} tQuaternionKernels;
+
+	// The kernels the CPU supports, slowest first.
+	static std::vector<tQuaternionKernels> supportedQuaternionKernels() {
+		std::vector<tQuaternionKernels> kernels;
+		tQuaternionKernels scalar = { "scalar", multiplyScalar, slerpScalar, matricesScalar };
+		kernels.push_back(scalar);
+#ifdef CG_QUATERNION_X86
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("sse2")) {
+			tQuaternionKernels sse2 = { "sse2", multiplySSE2, slerpSSE2, matricesSSE2 };
+			kernels.push_back(sse2);
+		}
+		if(__builtin_cpu_supports("avx")) {
+			tQuaternionKernels avx = { "avx", multiplyAVX, slerpAVX, matricesAVX };
+			kernels.push_back(avx);
+		}
+#endif
+		return kernels;
+	}
+	static tQuaternionKernels& getQuaternionKernels() {
+		static tQuaternionKernels kernels = supportedQuaternionKernels().back();
+		return kernels;
+	}
+
+	//---<QuaternionArray>---
+
+	QuaternionArray::QuaternionArray() {
+	}
+	QuaternionArray::QuaternionArray(unsigned int n) {
+		resize(n);
+	}
+	QuaternionArray::~QuaternionArray() {
+	}
+	void QuaternionArray::resize(unsigned int n) {
+		_x.resize(n, 0);
+		_y.resize(n, 0);
+		_z.resize(n, 0);
+		_w.resize(n, 1);
+	}
+	unsigned int QuaternionArray::size() const {
+		return _w.size();
+	}
+	void QuaternionArray::set(unsigned int i, const Quaternionf& q) {
+		_x[i] = q.v[0];
+		_y[i] = q.v[1];
+		_z[i] = q.v[2];
+		_w[i] = q.w;
+	}
+	const Quaternionf QuaternionArray::get(unsigned int i) const {
+		return Quaternionf(_x[i], _y[i], _z[i], _w[i]);
+	}
+	float* QuaternionArray::getX() { return &_x[0]; }
+	float* QuaternionArray::getY() { return &_y[0]; }
+	float* QuaternionArray::getZ() { return &_z[0]; }
+	float* QuaternionArray::getW() { return &_w[0]; }
+	const float* QuaternionArray::getX() const { return &_x[0]; }
+	const float* QuaternionArray::getY() const { return &_y[0]; }
+	const float* QuaternionArray::getZ() const { return &_z[0]; }
+	const float* QuaternionArray::getW() const { return &_w[0]; }
+
+	void QuaternionArray::multiply(const QuaternionArray& a, const QuaternionArray& b) {
+		if(a.size() != b.size()) {
+			throw std::runtime_error("[cg::QuaternionArray] arrays must have the same size.");
+		}
+		resize(a.size());
+		if(size() == 0) {
+			return;
+		}
+		const float* const qa[4] = { a.getX(), a.getY(), a.getZ(), a.getW() };
+		const float* const qb[4] = { b.getX(), b.getY(), b.getZ(), b.getW() };
+		float* const r[4] = { getX(), getY(), getZ(), getW() };
+		getQuaternionKernels().multiply(qa, qb, r, 0, size());
+	}
+	void QuaternionArray::slerp(const QuaternionArray& q0, const QuaternionArray& q1, float t) {
+		if(q0.size() != q1.size()) {
+			throw std::runtime_error("[cg::QuaternionArray] arrays must have the same size.");
+		}
+		if(t < 0 || t > 1) {
+			throw std::runtime_error("[cg::QuaternionArray] slerp t must be in [0,1].");
+		}
+		resize(q0.size());
+		if(size() == 0) {
+			return;
+		}
+		const float* const qa[4] = { q0.getX(), q0.getY(), q0.getZ(), q0.getW() };
+		const float* const qb[4] = { q1.getX(), q1.getY(), q1.getZ(), q1.getW() };
+		float* const r[4] = { getX(), getY(), getZ(), getW() };
+		getQuaternionKernels().slerp(qa, qb, t, r, 0, size());
+	}
+	void QuaternionArray::getMatrices(float* matrices) const {
+		if(size() > 0) {
+			const float* const q[4] = { getX(), getY(), getZ(), getW() };
+			getQuaternionKernels().matrices(q, matrices, false, 0, size());
+		}
+	}
+	void QuaternionArray::getGLMatrices(float* matrices) const {
+		if(size() > 0) {
+			const float* const q[4] = { getX(), getY(), getZ(), getW() };
+			getQuaternionKernels().matrices(q, matrices, true, 0, size());
+		}
+	}
+
+	// Names of the kernels the CPU supports, slowest first.
+	std::vector<std::string> QuaternionArray::getKernels() {
+		std::vector<tQuaternionKernels> kernels = supportedQuaternionKernels();
+		std::vector<std::string> names;
+		for(unsigned int i = 0; i < kernels.size(); i++) {
+			names.push_back(kernels[i].name);
+		}
+		return names;
+	}
+	// Selects the kernels by name, and returns false if the CPU does not
+	// support them. Not to be called while other threads use the arrays.
+	bool QuaternionArray::setKernel(const std::string& name) {
+		std::vector<tQuaternionKernels> kernels = supportedQuaternionKernels();
+		for(unsigned int i = 0; i < kernels.size(); i++) {
+			if(name == kernels[i].name) {
+				getQuaternionKernels() = kernels[i];
+				return true;
+			}
+		}
+		return false;
+	}
+
+}
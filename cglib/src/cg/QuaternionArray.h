@@ -0,0 +1,81 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef QUATERNION_ARRAY_H
+#define QUATERNION_ARRAY_H
+
+#include <string>
+#include <vector>
+#include "Quaternion.h"
+
+namespace cg {
+
+	/** cg::QuaternionArray stores n single precision quaternions as four
+	 *  separate x, y, z and w arrays and provides batch versions of the
+	 *  cg::Quaternion operations, computed with the widest SIMD instructions
+	 *  the CPU supports (AVX, SSE2 or scalar, selected once at runtime):
+	 *    cg::QuaternionArray::multiply - element-wise product of two arrays,
+	 *        with the same operations as cg::Quaternion::operator*.
+	 *    cg::QuaternionArray::slerp - element-wise slerp of two arrays with a
+	 *        shared t in [0,1], along the shortest path: unlike the
+	 *        cg::Quaternion slerp, the second quaternion is negated when the
+	 *        dot product is negative, so nearly opposite pairs (nearly the
+	 *        same rotation) do not divide by sin(angle) ~ 0. acos and sin are
+	 *        polynomial approximations (error below 1e-6), and nearly equal
+	 *        pairs are interpolated linearly.
+	 *    cg::QuaternionArray::getMatrices and getGLMatrices - rotation
+	 *        matrices of every quaternion, column-major, 9 or 16 floats each,
+	 *        ready for glMultMatrixf or a uniform/buffer upload.
+	 *  Results and operands may be the same array.
+	 *  cg::QuaternionArray::setKernel selects another of the kernels listed
+	 *  by cg::QuaternionArray::getKernels.
+	 */
+	class QuaternionArray {
+
+	private:
+		std::vector<float> _x, _y, _z, _w;
+
+	public:
+		QuaternionArray();
+		QuaternionArray(unsigned int n);
+		~QuaternionArray();
+
+		void resize(unsigned int n);
+		unsigned int size() const;
+		void set(unsigned int i, const Quaternionf& q);
+		const Quaternionf get(unsigned int i) const;
+		float* getX();
+		float* getY();
+		float* getZ();
+		float* getW();
+		const float* getX() const;
+		const float* getY() const;
+		const float* getZ() const;
+		const float* getW() const;
+
+		void multiply(const QuaternionArray& a, const QuaternionArray& b);
+		void slerp(const QuaternionArray& q0, const QuaternionArray& q1, float t);
+		void getMatrices(float* matrices) const;
+		void getGLMatrices(float* matrices) const;
+
+		static std::vector<std::string> getKernels();
+		static bool setKernel(const std::string& name);
+	};
+
+}
+
+#endif // QUATERNION_ARRAY_H
@@ -0,0 +1,104 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "Random.h"
+
+namespace cg {
+
+	uint32_t Random::_seed = 1;
+	unsigned long Random::_seedEpoch = 0;
+	uint32_t Random::_nextStream = 0;
+	pthread_key_t Random::_localKey;
+	pthread_once_t Random::_localOnce = PTHREAD_ONCE_INIT;
+
+	// splitmix32 step, used to expand a (seed, stream) pair into full state
+	static uint32_t splitmix(uint32_t& x) {
+		uint32_t z = (x += 0x9e3779b9);
+		z = (z ^ (z >> 16)) * 0x85ebca6b;
+		z = (z ^ (z >> 13)) * 0xc2b2ae35;
+		return z ^ (z >> 16);
+	}
+
+	Random::Random(uint32_t seed, uint32_t stream) {
+		_epoch = 0;
+		_stream = stream;
+		this->seed(seed, stream);
+	}
+	Random::~Random() {
+	}
+	void Random::seed(uint32_t seed, uint32_t stream) {
+		uint32_t x = seed ^ splitmix(stream);
+		for (int i = 0; i < 4; i++) {
+			_s[i] = splitmix(x);
+		}
+		for (int i = 0; i < 4; i++) {
+			for (int l = 0; l < 4; l++) {
+				_lanes[i][l] = splitmix(x);
+			}
+		}
+	}
+	void Random::fill(float* out, unsigned int n, float min, float max) {
+		const float scale = (max - min) * (1.0f / 16777216.0f);
+		uint32_t* s0 = _lanes[0];
+		uint32_t* s1 = _lanes[1];
+		uint32_t* s2 = _lanes[2];
+		uint32_t* s3 = _lanes[3];
+		unsigned int i = 0;
+		while (i < n) {
+			uint32_t result[4];
+			for (int l = 0; l < 4; l++) {
+				result[l] = s0[l] + s3[l];
+				uint32_t t = s1[l] << 9;
+				s2[l] ^= s0[l];
+				s3[l] ^= s1[l];
+				s1[l] ^= s2[l];
+				s0[l] ^= s3[l];
+				s2[l] ^= t;
+				s3[l] = (s3[l] << 11) | (s3[l] >> 21);
+			}
+			for (int l = 0; l < 4 && i < n; l++, i++) {
+				out[i] = (int)(result[l] >> 8) * scale + min;
+			}
+		}
+	}
+
+	void Random::setSeed(uint32_t seed) {
+		_seed = seed;
+		__sync_fetch_and_add(&_seedEpoch, 1);
+	}
+	uint32_t Random::getSeed() {
+		return _seed;
+	}
+	void Random::createLocalKey() {
+		pthread_key_create(&_localKey, deleteLocal);
+	}
+	void Random::deleteLocal(void* random) {
+		delete (Random*)random;
+	}
+	Random& Random::local() {
+		pthread_once(&_localOnce, createLocalKey);
+		Random* random = (Random*)pthread_getspecific(_localKey);
+		if (random == 0) {
+			random = new Random(_seed, __sync_fetch_and_add(&_nextStream, 1));
+			random->_epoch = _seedEpoch;
+			pthread_setspecific(_localKey, random);
+		} else if (random->_epoch != _seedEpoch) {
+			random->seed(_seed, random->_stream);
+			random->_epoch = _seedEpoch;
+		}
+		return *random;
+	}
+}
@@ -0,0 +1,93 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+namespace cg {
+
+	/** cg::Random is a small, fast and seedable pseudo-random number generator
+	 *  (xoshiro128+). Every generator is identified by a (seed, stream) pair:
+	 *  generators with the same pair produce the same sequence, and different
+	 *  streams of the same seed are statistically independent.
+	 *  cg::Random::fill draws many uniform floats at once from four interleaved
+	 *  generator lanes, which the compiler turns into SIMD code.
+	 *  cg::Random::local returns a generator owned by the calling thread. The
+	 *  n-th thread to call it gets stream n of the global seed set with
+	 *  cg::Random::setSeed, so the main thread, which calls it first, always
+	 *  gets stream 0 and a run can be replayed from its seed.
+	 */
+	class Random {
+
+	private:
+		uint32_t _s[4];
+		uint32_t _lanes[4][4];
+		unsigned long _epoch;
+
+		static uint32_t _seed;
+		static unsigned long _seedEpoch;
+		static uint32_t _nextStream;
+		static pthread_key_t _localKey;
+		static pthread_once_t _localOnce;
+		uint32_t _stream;
+
+		static void createLocalKey();
+		static void deleteLocal(void* random);
+
+	public:
+		Random(uint32_t seed = 1, uint32_t stream = 0);
+		~Random();
+
+		void seed(uint32_t seed, uint32_t stream = 0);
+		uint32_t next();
+		float nextFloat();
+		double nextDouble();
+		double between(double min, double max);
+		void fill(float* out, unsigned int n, float min, float max);
+
+		static void setSeed(uint32_t seed);
+		static uint32_t getSeed();
+		static Random& local();
+	};
+
+	inline uint32_t Random::next() {
+		uint32_t result = _s[0] + _s[3];
+		uint32_t t = _s[1] << 9;
+		_s[2] ^= _s[0];
+		_s[3] ^= _s[1];
+		_s[1] ^= _s[2];
+		_s[0] ^= _s[3];
+		_s[2] ^= t;
+		_s[3] = (_s[3] << 11) | (_s[3] >> 21);
+		return result;
+	}
+	inline float Random::nextFloat() {
+		return (next() >> 8) * (1.0f / 16777216.0f);
+	}
+	inline double Random::nextDouble() {
+		uint32_t hi = next() >> 5;
+		uint32_t lo = next() >> 6;
+		return (hi * 67108864.0 + lo) * (1.0 / 9007199254740992.0);
+	}
+	inline double Random::between(double min, double max) {
+		return nextDouble() * (max - min) + min;
+	}
+}
+
+#endif // RANDOM_H
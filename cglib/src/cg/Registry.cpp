@@ -29,6 +29,7 @@ namespace cg {
         return _instance;
 	}
     Registry::Registry() {
+		_size = 0;
 	}
     Registry::~Registry() {
 		shutdown();
@@ -38,23 +39,59 @@ namespace cg {
 	}
 
 	void Registry::init() {
-		for (tEntityIterator i = _entities.begin(); i != _entities.end(); i++) {
-			i->second->init();
+		for (unsigned int i = 0; i < _slots.size(); i++) {
+			if(_slots[i].entity) {
+				_slots[i].entity->init();
+			}
 		}
 	}
 	unsigned int Registry::size() const{
-		return (unsigned int)_entities.size();
+		return _size;
     }
 	bool Registry::exists(const std::string& id) {
-		return (_entities.count(id) != 0);
+		return (_names.count(id) != 0);
+	}
+	bool Registry::exists(const EntityHandle& handle) const {
+		return get(handle) != 0;
 	}
 	Entity* Registry::get(const std::string& id) {
-		tEntityIterator i = _entities.find(id);
-		if(i != _entities.end()) {
+		tNameIterator i = _names.find(id);
+		if(i != _names.end()) {
 			return i->second;
 		}
 		return 0;
 	}
+	Entity* Registry::get(const EntityHandle& handle) const {
+		if(handle.index < _slots.size() && _slots[handle.index].generation == handle.generation) {
+			return _slots[handle.index].entity;
+		}
+		return 0;
+	}
+	EntityHandle Registry::getHandle(const std::string& id) {
+		Entity* entity = get(id);
+		if(entity) {
+			return entity->getHandle();
+		}
+		return EntityHandle();
+	}
+	#define CHECK_ENTITY(entity,NOTIFIER,LISTENER)\
+		{ LISTENER* l = dynamic_cast<LISTENER*>(entity);\
+		  if(l && NOTIFIER::instance()->exists(entity->getId())) {\
+			  throw std::runtime_error("[cg::Registry] entity '" + entity->getId() + "' already exists in cg::" #NOTIFIER ".");\
+		  }}
+
+	// Throws if a notifier the entity listens to already has its identifier.
+	inline
+	void Registry::checkEntity(Entity* entity) {
+		CHECK_ENTITY(entity,KeyboardEventNotifier,IKeyboardEventListener)
+		CHECK_ENTITY(entity,MouseEventNotifier,IMouseEventListener)
+		CHECK_ENTITY(entity,ReshapeEventNotifier,IReshapeEventListener)
+		CHECK_ENTITY(entity,UpdateNotifier,IUpdateListener)
+		CHECK_ENTITY(entity,DrawNotifier,IDrawListener)
+		CHECK_ENTITY(entity,DrawOverlayNotifier,IDrawOverlayListener)
+		CHECK_ENTITY(entity,DebugNotifier,IDebugListener)
+	}
+
 	#define CONNECT_ENTITY(entity,NOTIFIER,LISTENER)\
 		{ LISTENER* l = dynamic_cast<LISTENER*>(entity);\
 		  if(l) { NOTIFIER::instance()->add(l); }}
@@ -69,14 +106,49 @@ namespace cg {
 		CONNECT_ENTITY(entity,DrawOverlayNotifier,IDrawOverlayListener)
 		CONNECT_ENTITY(entity,DebugNotifier,IDebugListener)
 	}
-	void Registry::add(Entity* entity) {
-		std::string id = entity->getId();
-		std::pair<tEntityIterator,bool> result = _entities.insert(std::make_pair(id, entity));
-		if(result.second == false) {
-			throw std::runtime_error("[cg::Registry] entity '" + id + "' already exists.");
+	// Everything that can fail is checked before the registry or any
+	// notifier changes, so that a failed add leaves no trace of the entity.
+	EntityHandle Registry::add(Entity* entity, bool is_indexed) {
+		tNameIterator name = _names.lower_bound(entity->getId());
+		if(is_indexed && name != _names.end() && name->first == entity->getId()) {
+			throw std::runtime_error("[cg::Registry] entity '" + entity->getId() + "' already exists.");
+		}
+		checkEntity(entity);
+		if(is_indexed) {
+			_names.insert(name, std::make_pair(entity->getId(), entity));
+		}
+		uint32_t index;
+		if(_freeSlots.empty()) {
+			index = (uint32_t)_slots.size();
+			tEntitySlot slot;
+			slot.entity = 0;
+			slot.generation = 1;
+			slot.isIndexed = false;
+			_slots.push_back(slot);
 		} else {
-			connectEntity(entity);
+			index = _freeSlots.back();
+			_freeSlots.pop_back();
 		}
+		_slots[index].entity = entity;
+		_slots[index].isIndexed = is_indexed;
+		entity->_handle = EntityHandle(index, _slots[index].generation);
+		_size++;
+		connectEntity(entity);
+		return entity->_handle;
+	}
+	// Frees the slot of the entity, invalidating all handles to it.
+	inline
+	void Registry::releaseSlot(Entity* entity) {
+		tEntitySlot& slot = _slots[entity->_handle.index];
+		if(slot.isIndexed) {
+			_names.erase(entity->getId());
+		}
+		slot.entity = 0;
+		slot.isIndexed = false;
+		slot.generation = EntityHandle::nextGeneration(slot.generation);
+		_freeSlots.push_back(entity->_handle.index);
+		entity->_handle = EntityHandle();
+		_size--;
 	}
 
 	#define DISCONNECT_ENTITY(entity,NOTIFIER,LISTENER)\
@@ -94,34 +166,46 @@ namespace cg {
 		DISCONNECT_ENTITY(entity,DebugNotifier,IDebugListener)
 	}
 	void Registry::remove(const std::string& id) {
-		tEntityIterator i = _entities.find(id);
-		if(i != _entities.end()) {
-			disconnectEntity(i->second);
-			_entities.erase(id);
+		remove(getHandle(id));
+	}
+	void Registry::remove(const EntityHandle& handle) {
+		Entity* entity = get(handle);
+		if(entity) {
+			disconnectEntity(entity);
+			releaseSlot(entity);
 		}
 	}
 	void Registry::removeAll() {
-		for (tEntityIterator i = _entities.begin(); i != _entities.end(); i++) {
-			disconnectEntity(i->second);
+		for (unsigned int i = 0; i < _slots.size(); i++) {
+			if(_slots[i].entity) {
+				Entity* entity = _slots[i].entity;
+				disconnectEntity(entity);
+				releaseSlot(entity);
+			}
 		}
-		_entities.clear();
+		_names.clear();
 	}
 	void Registry::destroy(const std::string& id) {
-		tEntityIterator i = _entities.find(id);
-		if(i != _entities.end()) {
-			Entity* entity = i->second;
+		destroy(getHandle(id));
+	}
+	void Registry::destroy(const EntityHandle& handle) {
+		Entity* entity = get(handle);
+		if(entity) {
 			disconnectEntity(entity);
+			releaseSlot(entity);
 			delete entity;
-			_entities.erase(id);
 		}
 	}
 	void Registry::destroyAll() {
-		for (tEntityIterator i = _entities.begin(); i != _entities.end(); i++) {
-			Entity* entity = i->second;
-			disconnectEntity(entity);
-			delete entity;
+		for (unsigned int i = 0; i < _slots.size(); i++) {
+			if(_slots[i].entity) {
+				Entity* entity = _slots[i].entity;
+				disconnectEntity(entity);
+				releaseSlot(entity);
+				delete entity;
+			}
 		}
-		_entities.clear();
+		_names.clear();
 	}
 
 	#define DUMP_ENTITY(entity,LISTENER,tab)\
@@ -149,17 +233,22 @@ namespace cg {
 		DUMP_ENTITY(entity,GroupReshapeEvent,tab)
 	}
 	void Registry::dump() {
-		std::ofstream& file = DebugFile::instance()->getOutputFileStream();
+		DebugFileLock debug_file_lock;
+		std::ofstream& file = debug_file_lock.getOutputFileStream();
 		file << "[Registry] (" << size() << ")" << std::endl;
-		for (tEntityIterator i = _entities.begin(); i != _entities.end(); i++) {
-			dumpEntity(i->second, file);
+		for (unsigned int i = 0; i < _slots.size(); i++) {
+			if(_slots[i].entity) {
+				dumpEntity(_slots[i].entity, file);
+			}
 		}
 	}
 	void Registry::shutdown() {
-		for (tEntityIterator i = _entities.begin(); i != _entities.end(); i++) {
-			Entity* entity = i->second;
-			delete entity;
+		for (unsigned int i = 0; i < _slots.size(); i++) {
+			delete _slots[i].entity;
 		}
-		_entities.clear();
+		_slots.clear();
+		_freeSlots.clear();
+		_names.clear();
+		_size = 0;
 	}
 }
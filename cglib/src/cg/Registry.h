@@ -21,11 +21,14 @@
 
 #include <fstream>
 #include <map>
+#include <stdint.h>
+#include <vector>
 #include "DebugFile.h"
 #include "DebugNotifier.h"
 #include "DrawNotifier.h"
 #include "DrawOverlayNotifier.h"
 #include "Entity.h"
+#include "EntityHandle.h"
 #include "GroupDebug.h"
 #include "GroupDraw.h"
 #include "GroupDrawOverlay.h"
@@ -51,6 +54,19 @@ namespace cg {
 	 *  of all cg::Entity of the application. When the cg::Registry::init
 	 *  method is invoked, all the entities are called through
 	 *  the cg::Entity::init method, independently of being enabled or not.
+	 *  Entities are kept in a table of slots, addressed in constant time by
+	 *  the cg::EntityHandle returned by cg::Registry::add. Freed slots are
+	 *  reused, but each removal bumps the generation of the slot, so a handle
+	 *  to a removed entity is stale: cg::Registry::get returns 0 for it.
+	 *  The entity identifiers are kept in a separate name index, used only
+	 *  by the methods taking a string. Entities added with is_indexed set to
+	 *  false skip that index: they are only reachable through their handle,
+	 *  and their identifiers need not be unique in the registry (the
+	 *  notifiers they listen to still require distinct identifiers, which
+	 *  cg::Registry::add checks before adding the entity anywhere).
+	 *  cg::Registry::init, cg::Registry::dump and cg::Registry::destroyAll
+	 *  walk the slot table, so the entities are visited in insertion order
+	 *  only until a freed slot is reused.
 	 */
 
 	class Registry {
@@ -59,11 +75,22 @@ namespace cg {
 		static Registry* _instance;
 		Registry();
 
-		std::map<const std::string, Entity*> _entities;
-		typedef std::map<const std::string, Entity*>::iterator tEntityIterator;
+		typedef struct {
+			Entity* entity;
+			uint32_t generation;
+			bool isIndexed;
+		} tEntitySlot;
+		std::vector<tEntitySlot> _slots;
+		std::vector<uint32_t> _freeSlots;
+		unsigned int _size;
 
+		std::map<const std::string, Entity*> _names;
+		typedef std::map<const std::string, Entity*>::iterator tNameIterator;
+
+		void checkEntity(Entity* entity);
 		void connectEntity(Entity* entity);
 		void disconnectEntity(Entity* entity);
+		void releaseSlot(Entity* entity);
 		void dumpEntity(Entity* entity, std::ofstream& file);
 		void shutdown();
 
@@ -75,11 +102,16 @@ namespace cg {
 		void init();
 		unsigned int size() const;
 		bool exists(const std::string& id);
+		bool exists(const EntityHandle& handle) const;
 		Entity* get(const std::string& id);
-		void add(Entity* entity);
+		Entity* get(const EntityHandle& handle) const;
+		EntityHandle getHandle(const std::string& id);
+		EntityHandle add(Entity* entity, bool is_indexed = true);
 		void remove(const std::string& id);
+		void remove(const EntityHandle& handle);
 		void removeAll();
 		void destroy(const std::string& id);
+		void destroy(const EntityHandle& handle);
 		void destroyAll();
 		void dump();
 	};
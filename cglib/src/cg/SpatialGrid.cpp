@@ -0,0 +1,226 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace cg {
+
+	SpatialGrid::SpatialGrid() {
+		_cellSize = 1;
+		_columns = _rows = 0;
+	}
+	SpatialGrid::~SpatialGrid() {
+	}
+	void SpatialGrid::setup(double width, double height, double cell_size) {
+		if(width <= 0 || height <= 0 || cell_size <= 0) {
+			throw std::runtime_error("[cg::SpatialGrid] grid and cell sizes must be positive.");
+		}
+		_cellSize = cell_size;
+		_columns = (int)std::ceil(width / cell_size);
+		_rows = (int)std::ceil(height / cell_size);
+		_cells.assign(_columns * _rows, std::vector<uint32_t>());
+		for(uint32_t id = 0; id < _objects.size(); id++) {
+			if(_objects[id].isActive) {
+				_objects[id].isActive = false;
+				Vector2d bottomleft(_objects[id].minX, _objects[id].minY);
+				Vector2d topright(_objects[id].maxX, _objects[id].maxY);
+				update(id, bottomleft, topright);
+			}
+		}
+	}
+	void SpatialGrid::setup(const tWindow& window, double cell_size) {
+		setup(window.width, window.height, cell_size);
+	}
+	void SpatialGrid::clear() {
+		for(std::vector<std::vector<uint32_t> >::iterator i = _cells.begin(); i != _cells.end(); i++) {
+			i->clear();
+		}
+		_objects.clear();
+	}
+	inline
+	int SpatialGrid::column(double x) const {
+		int c = (int)std::floor(x / _cellSize);
+		return std::max(0, std::min(_columns - 1, c));
+	}
+	inline
+	int SpatialGrid::row(double y) const {
+		int r = (int)std::floor(y / _cellSize);
+		return std::max(0, std::min(_rows - 1, r));
+	}
+	void SpatialGrid::link(uint32_t id) {
+		tGridObject& o = _objects[id];
+		for(int y = o.cellMinY; y <= o.cellMaxY; y++) {
+			for(int x = o.cellMinX; x <= o.cellMaxX; x++) {
+				_cells[y * _columns + x].push_back(id);
+			}
+		}
+	}
+	void SpatialGrid::unlink(uint32_t id) {
+		tGridObject& o = _objects[id];
+		for(int y = o.cellMinY; y <= o.cellMaxY; y++) {
+			for(int x = o.cellMinX; x <= o.cellMaxX; x++) {
+				std::vector<uint32_t>& cell = _cells[y * _columns + x];
+				std::vector<uint32_t>::iterator i = std::find(cell.begin(), cell.end(), id);
+				*i = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+	void SpatialGrid::update(uint32_t id, const Vector2d& bottomleft, const Vector2d& topright) {
+		if(_columns == 0) {
+			throw std::runtime_error("[cg::SpatialGrid] grid used before setup.");
+		}
+		if(id >= _objects.size()) {
+			tGridObject inactive;
+			inactive.isActive = false;
+			inactive.polygon = 0;
+			_objects.resize(id + 1, inactive);
+		}
+		tGridObject& o = _objects[id];
+		o.minX = (float)bottomleft[0];
+		o.minY = (float)bottomleft[1];
+		o.maxX = (float)topright[0];
+		o.maxY = (float)topright[1];
+		int minX = column(o.minX), minY = row(o.minY);
+		int maxX = column(o.maxX), maxY = row(o.maxY);
+		if(o.isActive && minX == o.cellMinX && minY == o.cellMinY && maxX == o.cellMaxX && maxY == o.cellMaxY) {
+			return;
+		}
+		if(o.isActive) {
+			unlink(id);
+		}
+		o.cellMinX = minX;
+		o.cellMinY = minY;
+		o.cellMaxX = maxX;
+		o.cellMaxY = maxY;
+		o.isActive = true;
+		link(id);
+	}
+	// The polygon is not copied: it must stay valid, in world coordinates,
+	// for as long as it is set. 0 removes it.
+	void SpatialGrid::setPolygon(uint32_t id, std::vector<Vector2d>* polygon) {
+		if(id < _objects.size() && _objects[id].isActive) {
+			_objects[id].polygon = polygon;
+		}
+	}
+	void SpatialGrid::remove(uint32_t id) {
+		if(id < _objects.size() && _objects[id].isActive) {
+			unlink(id);
+			_objects[id].isActive = false;
+			_objects[id].polygon = 0;
+		}
+	}
+
+	static bool isSegmentIntersection(const Vector2d& p0, const Vector2d& p1, const Vector2d& q0, const Vector2d& q1) {
+		double d0 = (p1[0] - p0[0]) * (q0[1] - p0[1]) - (p1[1] - p0[1]) * (q0[0] - p0[0]);
+		double d1 = (p1[0] - p0[0]) * (q1[1] - p0[1]) - (p1[1] - p0[1]) * (q1[0] - p0[0]);
+		double d2 = (q1[0] - q0[0]) * (p0[1] - q0[1]) - (q1[1] - q0[1]) * (p0[0] - q0[0]);
+		double d3 = (q1[0] - q0[0]) * (p1[1] - q0[1]) - (q1[1] - q0[1]) * (p1[0] - q0[0]);
+		return ((d0 <= 0 && d1 >= 0) || (d0 >= 0 && d1 <= 0)) && ((d2 <= 0 && d3 >= 0) || (d2 >= 0 && d3 <= 0));
+	}
+	static void boxPolygon(float minX, float minY, float maxX, float maxY, std::vector<Vector2d>& polygon) {
+		polygon.resize(4);
+		polygon[0] = Vector2d(minX, minY);
+		polygon[1] = Vector2d(maxX, minY);
+		polygon[2] = Vector2d(maxX, maxY);
+		polygon[3] = Vector2d(minX, maxY);
+	}
+	// Two polygons overlap if an edge of one crosses an edge of the other,
+	// or if one of them is inside the other. A box stands in for a missing
+	// polygon.
+	bool SpatialGrid::isPolygonCollision(tGridObject& a, tGridObject& b) {
+		std::vector<Vector2d> boxA, boxB;
+		if(a.polygon == 0) {
+			boxPolygon(a.minX, a.minY, a.maxX, a.maxY, boxA);
+		}
+		if(b.polygon == 0) {
+			boxPolygon(b.minX, b.minY, b.maxX, b.maxY, boxB);
+		}
+		std::vector<Vector2d>& pa = a.polygon ? *a.polygon : boxA;
+		std::vector<Vector2d>& pb = b.polygon ? *b.polygon : boxB;
+		if(pa.empty() || pb.empty()) {
+			return false;
+		}
+		for(unsigned int i = 0, j = pa.size() - 1; i < pa.size(); j = i++) {
+			for(unsigned int k = 0, l = pb.size() - 1; k < pb.size(); l = k++) {
+				if(isSegmentIntersection(pa[j], pa[i], pb[l], pb[k])) {
+					return true;
+				}
+			}
+		}
+		Util* util = Util::instance();
+		return util->isPointInPolygon(pa[0], pb) || util->isPointInPolygon(pb[0], pa);
+	}
+	void SpatialGrid::findPairs(std::vector<tCollisionPair>& pairs) {
+		pairs.clear();
+		Util* util = Util::instance();
+		for(int y = 0; y < _rows; y++) {
+			for(int x = 0; x < _columns; x++) {
+				std::vector<uint32_t>& cell = _cells[y * _columns + x];
+				unsigned int n = cell.size();
+				for(unsigned int i = 0; i < n; i++) {
+					tGridObject& a = _objects[cell[i]];
+					for(unsigned int j = i + 1; j < n; j++) {
+						tGridObject& b = _objects[cell[j]];
+						// a pair sharing several cells is only tested in the first of them
+						if(std::max(a.cellMinX, b.cellMinX) != x || std::max(a.cellMinY, b.cellMinY) != y) {
+							continue;
+						}
+						if(!util->isAABBoxCollision(Vector2d(a.minX, a.minY), Vector2d(a.maxX, a.maxY),
+								Vector2d(b.minX, b.minY), Vector2d(b.maxX, b.maxY))) {
+							continue;
+						}
+						if((a.polygon || b.polygon) && !isPolygonCollision(a, b)) {
+							continue;
+						}
+						tCollisionPair pair;
+						pair.a = std::min(cell[i], cell[j]);
+						pair.b = std::max(cell[i], cell[j]);
+						pairs.push_back(pair);
+					}
+				}
+			}
+		}
+	}
+	// Ids of the objects whose box overlaps the given box, each once.
+	void SpatialGrid::query(const Vector2d& bottomleft, const Vector2d& topright, std::vector<uint32_t>& ids) {
+		ids.clear();
+		if(_columns == 0) {
+			return;
+		}
+		int minX = column(bottomleft[0]), minY = row(bottomleft[1]);
+		int maxX = column(topright[0]), maxY = row(topright[1]);
+		Util* util = Util::instance();
+		for(int y = minY; y <= maxY; y++) {
+			for(int x = minX; x <= maxX; x++) {
+				std::vector<uint32_t>& cell = _cells[y * _columns + x];
+				for(unsigned int i = 0; i < cell.size(); i++) {
+					tGridObject& o = _objects[cell[i]];
+					if(std::max(o.cellMinX, minX) != x || std::max(o.cellMinY, minY) != y) {
+						continue;
+					}
+					if(util->isAABBoxCollision(bottomleft, topright, Vector2d(o.minX, o.minY), Vector2d(o.maxX, o.maxY))) {
+						ids.push_back(cell[i]);
+					}
+				}
+			}
+		}
+	}
+}
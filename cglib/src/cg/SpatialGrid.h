@@ -0,0 +1,83 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <stdint.h>
+#include <vector>
+#include "Application.h"
+#include "Util.h"
+#include "Vector.h"
+
+namespace cg {
+
+	typedef struct {
+		uint32_t a, b;
+	} tCollisionPair;
+
+	/** cg::SpatialGrid is a collision broad phase: a uniform grid covering the
+	 *  window, in which each object is registered in every cell its
+	 *  axis-aligned bounding box overlaps. Objects are identified by small
+	 *  integer ids chosen by the caller (e.g. indices in a dense array).
+	 *  cg::SpatialGrid::update only moves an object between cells when the
+	 *  range of cells it overlaps changes, so calling it for every object
+	 *  every frame keeps the grid up to date incrementally.
+	 *  cg::SpatialGrid::findPairs returns each colliding pair once, with
+	 *  a < b: candidates sharing a cell are narrowed with
+	 *  cg::Util::isAABBoxCollision and, when either object has a polygon
+	 *  (see cg::SpatialGrid::setPolygon), with an exact polygon overlap test
+	 *  built on cg::Util::isPointInPolygon.
+	 *  Boxes outside the window are clamped to the border cells.
+	 */
+	class SpatialGrid {
+
+	private:
+		typedef struct {
+			float minX, minY, maxX, maxY;
+			int cellMinX, cellMinY, cellMaxX, cellMaxY;
+			bool isActive;
+			std::vector<Vector2d>* polygon;
+		} tGridObject;
+
+		double _cellSize;
+		int _columns, _rows;
+		std::vector<tGridObject> _objects;
+		std::vector<std::vector<uint32_t> > _cells;
+
+		int column(double x) const;
+		int row(double y) const;
+		void link(uint32_t id);
+		void unlink(uint32_t id);
+		bool isPolygonCollision(tGridObject& a, tGridObject& b);
+
+	public:
+		SpatialGrid();
+		~SpatialGrid();
+
+		void setup(double width, double height, double cell_size);
+		void setup(const tWindow& window, double cell_size);
+		void clear();
+		void update(uint32_t id, const Vector2d& bottomleft, const Vector2d& topright);
+		void setPolygon(uint32_t id, std::vector<Vector2d>* polygon);
+		void remove(uint32_t id);
+		void findPairs(std::vector<tCollisionPair>& pairs);
+		void query(const Vector2d& bottomleft, const Vector2d& topright, std::vector<uint32_t>& ids);
+	};
+}
+
+#endif // SPATIAL_GRID_H
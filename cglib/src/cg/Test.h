@@ -41,6 +41,9 @@ namespace cg {
 	 *  TEST. Within each test use the macro CHECK to assert if a condition is true
 	 *  (as for the assert instruction), and the macro TEST_EXCEPTION to verify that 
 	 *  an exception is thrown.
+	 *  cg::Test::getFailureCount counts the failed checks (and the tests
+	 *  interrupted by an exception) of all the tests run so far, so that
+	 *  a test program can report them in its exit status.
 	 *  Look at the cglib.test project for concrete examples of use.
 	 */
 	class Test {
@@ -62,6 +65,7 @@ namespace cg {
 				test();
 			} catch(std::exception& e) {
 				std::cout << e.what() << std::endl;
+				failures()++;
 			}
 			std::cout << "    " << _testCount << " tests.";
 		}
@@ -70,8 +74,18 @@ namespace cg {
 		static void check(bool condition, const std::string label, long line) {
 			if( condition == false ) {
 				std::cout << "    fail [line " << line << "]: " << label << std::endl;
+				failures()++;
 			}
 		}
+		static int getFailureCount() {
+			return failures();
+		}
+
+	private:
+		static int& failures() {
+			static int count = 0;
+			return count;
+		}
 	};
 
 }
@@ -0,0 +1,156 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace cg {
+
+    ThreadPool* ThreadPool::_instance = 0;
+
+    ThreadPool* ThreadPool::instance() {
+        if (_instance == 0) {
+			_instance = new ThreadPool();
+		}
+        return _instance;
+	}
+    ThreadPool::ThreadPool() {
+		pthread_mutex_init(&_mutex, 0);
+		pthread_cond_init(&_workCondition, 0);
+		pthread_cond_init(&_doneCondition, 0);
+		_isShutdown = false;
+		_generation = 0;
+		_startGeneration = 0;
+		_pendingWorkers = 0;
+		_task = 0;
+		_count = _grain = _chunks = 0;
+		_nextChunk = 0;
+	}
+    ThreadPool::~ThreadPool() {
+		stop();
+		pthread_cond_destroy(&_doneCondition);
+		pthread_cond_destroy(&_workCondition);
+		pthread_mutex_destroy(&_mutex);
+	}
+    void ThreadPool::cleanup() {
+		delete _instance;
+		_instance = 0;
+	}
+
+	void ThreadPool::start(unsigned int thread_count) {
+		stop();
+		pthread_mutex_lock(&_mutex);
+		_isShutdown = false;
+		_startGeneration = _generation;
+		pthread_mutex_unlock(&_mutex);
+		// the calling thread also works, so it counts as one of the threads
+		for (unsigned int i = 1; i < thread_count; i++) {
+			pthread_t thread;
+			if (pthread_create(&thread, 0, workerMain, this) != 0) {
+				stop();
+				throw std::runtime_error("[cg::ThreadPool] cannot create worker thread.");
+			}
+			_threads.push_back(thread);
+		}
+	}
+	void ThreadPool::stop() {
+		pthread_mutex_lock(&_mutex);
+		_isShutdown = true;
+		pthread_cond_broadcast(&_workCondition);
+		pthread_mutex_unlock(&_mutex);
+		for (unsigned int i = 0; i < _threads.size(); i++) {
+			pthread_join(_threads[i], 0);
+		}
+		_threads.clear();
+	}
+	unsigned int ThreadPool::getThreadCount() const {
+		return (unsigned int)_threads.size() + 1;
+	}
+	void* ThreadPool::workerMain(void* arg) {
+		((ThreadPool*)arg)->work();
+		return 0;
+	}
+	void ThreadPool::work() {
+		pthread_mutex_lock(&_mutex);
+		// runs before the pool was started are not this worker's to check in
+		// for; _generation itself may already count a run started since
+		unsigned long seen = _startGeneration;
+		while (true) {
+			while (!_isShutdown && _generation == seen) {
+				pthread_cond_wait(&_workCondition, &_mutex);
+			}
+			if (_isShutdown) {
+				break;
+			}
+			seen = _generation;
+			pthread_mutex_unlock(&_mutex);
+			runChunks();
+			pthread_mutex_lock(&_mutex);
+			if (--_pendingWorkers == 0) {
+				pthread_cond_signal(&_doneCondition);
+			}
+		}
+		pthread_mutex_unlock(&_mutex);
+	}
+	inline
+	void ThreadPool::runChunks() {
+		unsigned int chunk;
+		while ((chunk = __sync_fetch_and_add(&_nextChunk, 1)) < _chunks) {
+			unsigned int begin = chunk * _grain;
+			unsigned int end = begin + _grain;
+			if (end > _count) {
+				end = _count;
+			}
+			_task->run(begin, end);
+		}
+	}
+	void ThreadPool::run(IParallelTask* task, unsigned int count, unsigned int grain) {
+		if (count == 0) {
+			return;
+		}
+		if (grain == 0) {
+			grain = 1;
+		}
+		// serially, the same chunks are run in order
+		if (_threads.empty() || count <= grain) {
+			for (unsigned int begin = 0; begin < count; begin += grain) {
+				task->run(begin, std::min(begin + grain, count));
+			}
+			return;
+		}
+		pthread_mutex_lock(&_mutex);
+		_task = task;
+		_count = count;
+		_grain = grain;
+		_chunks = (count + grain - 1) / grain;
+		_nextChunk = 0;
+		_pendingWorkers = (unsigned int)_threads.size();
+		_generation++;
+		pthread_cond_broadcast(&_workCondition);
+		pthread_mutex_unlock(&_mutex);
+
+		runChunks();
+
+		// every worker checks in once per run, even if it found no chunk left,
+		// so none of them can still be reading this run's task afterwards
+		pthread_mutex_lock(&_mutex);
+		while (_pendingWorkers > 0) {
+			pthread_cond_wait(&_doneCondition, &_mutex);
+		}
+		_task = 0;
+		pthread_mutex_unlock(&_mutex);
+	}
+}
@@ -0,0 +1,71 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <stdexcept>
+#include <vector>
+#include "IParallelTask.h"
+
+namespace cg {
+
+	/** cg::ThreadPool is a singleton maintaining a set of persistent worker
+	 *  threads. cg::ThreadPool::run splits an index range in fixed-size
+	 *  chunks that are processed by the workers and by the calling thread,
+	 *  and only returns when every chunk is done.
+	 *  Chunk boundaries depend only on the range and the grain, never on the
+	 *  number of threads, so a task that writes only to its own chunk gives
+	 *  the same result whatever the thread count.
+	 *  Until cg::ThreadPool::start is called, run executes the same chunks
+	 *  serially, in order.
+	 */
+	class ThreadPool {
+
+	private:
+		static ThreadPool* _instance;
+		ThreadPool();
+
+		std::vector<pthread_t> _threads;
+		pthread_mutex_t _mutex;
+		pthread_cond_t _workCondition;
+		pthread_cond_t _doneCondition;
+		bool _isShutdown;
+		unsigned long _generation, _startGeneration;
+		unsigned int _pendingWorkers;
+
+		IParallelTask* _task;
+		unsigned int _count, _grain, _chunks;
+		volatile unsigned int _nextChunk;
+
+		static void* workerMain(void* arg);
+		void work();
+		void runChunks();
+
+	public:
+		static ThreadPool* instance();
+		virtual ~ThreadPool();
+		void cleanup();
+
+		void start(unsigned int thread_count);
+		void stop();
+		unsigned int getThreadCount() const;
+		void run(IParallelTask* task, unsigned int count, unsigned int grain);
+	};
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,244 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#include "Tracer.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "DebugFile.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace cg {
+
+	static bool hasInvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+		unsigned int eax, ebx, ecx, edx;
+		if(__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+			return (edx & (1 << 8)) != 0;
+		}
+#endif
+		return false;
+	}
+
+	static void writeJsonString(std::ostream& out, const std::string& s) {
+		out << '"';
+		for(std::string::const_iterator i = s.begin(); i != s.end(); i++) {
+			unsigned char c = (unsigned char)*i;
+			if(c == '"' || c == '\\') {
+				out << '\\' << *i;
+			} else if(c < 0x20) {
+				out << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 15];
+			} else {
+				out << *i;
+			}
+		}
+		out << '"';
+	}
+
+	Tracer* Tracer::_instance = 0;
+	pthread_mutex_t Tracer::_namesMutex = PTHREAD_MUTEX_INITIALIZER;
+	std::vector<std::string>* Tracer::_names = 0;
+	std::map<std::string, uint32_t>* Tracer::_nameIndex = 0;
+
+	Tracer::Tracer() {
+		pthread_key_create(&_key, 0);
+		pthread_mutex_init(&_buffersMutex, 0);
+		_capacity = DEFAULT_CAPACITY;
+		_isRecording = false;
+		_isTracingEntities = false;
+		_isUsingTsc = hasInvariantTsc();
+		_startTicks = _stopTicks = ticks();
+		_startNanos = _stopNanos = Clock::nanoseconds();
+	}
+	Tracer::~Tracer() {
+		_isRecording = false;
+		for(std::vector<TraceBuffer*>::iterator i = _buffers.begin(); i != _buffers.end(); i++) {
+			delete [] (*i)->events;
+			delete (*i);
+		}
+		pthread_key_delete(_key);
+		pthread_mutex_destroy(&_buffersMutex);
+	}
+	void Tracer::cleanup() {
+		delete _instance;
+		_instance = 0;
+	}
+	uint32_t Tracer::getNameId(const std::string& name) {
+		pthread_mutex_lock(&_namesMutex);
+		if(_names == 0) {
+			// id 0 is never returned, so that it can mean "not registered yet"
+			_names = new std::vector<std::string>(1);
+			_nameIndex = new std::map<std::string, uint32_t>();
+		}
+		uint32_t id;
+		std::map<std::string, uint32_t>::iterator i = _nameIndex->find(name);
+		if(i != _nameIndex->end()) {
+			id = i->second;
+		} else {
+			id = (uint32_t)_names->size();
+			_names->push_back(name);
+			(*_nameIndex)[name] = id;
+		}
+		pthread_mutex_unlock(&_namesMutex);
+		return id;
+	}
+	std::string Tracer::getName(uint32_t id) {
+		pthread_mutex_lock(&_namesMutex);
+		std::string name = (_names != 0 && id < _names->size()) ? (*_names)[id] : "?";
+		pthread_mutex_unlock(&_namesMutex);
+		return name;
+	}
+	void Tracer::allocate(TraceBuffer* buffer) {
+		if(buffer->capacity != _capacity) {
+			delete [] buffer->events;
+			// zeroed, so that page faults are taken here rather than while recording
+			buffer->events = new tTraceEvent[_capacity]();
+			buffer->capacity = _capacity;
+		}
+		buffer->size = 0;
+		buffer->dropped = 0;
+	}
+	TraceBuffer* Tracer::registerThread() {
+		TraceBuffer* buffer = new TraceBuffer();
+		buffer->events = 0;
+		buffer->capacity = 0;
+		allocate(buffer);
+		pthread_mutex_lock(&_buffersMutex);
+		buffer->thread = (unsigned int)_buffers.size();
+		_buffers.push_back(buffer);
+		pthread_mutex_unlock(&_buffersMutex);
+		pthread_setspecific(_key, buffer);
+		return buffer;
+	}
+	void Tracer::start(unsigned int capacity) {
+		if(capacity == 0) {
+			throw std::runtime_error("[cg::Tracer] capacity must be positive.");
+		}
+		_isRecording = false;
+		_capacity = capacity;
+		pthread_mutex_lock(&_buffersMutex);
+		for(std::vector<TraceBuffer*>::iterator i = _buffers.begin(); i != _buffers.end(); i++) {
+			allocate(*i);
+		}
+		pthread_mutex_unlock(&_buffersMutex);
+		if(pthread_getspecific(_key) == 0) {
+			registerThread();
+		}
+		_startTicks = ticks();
+		_startNanos = Clock::nanoseconds();
+		_isRecording = true;
+	}
+	void Tracer::stop() {
+		if(_isRecording) {
+			_isRecording = false;
+			_stopTicks = ticks();
+			_stopNanos = Clock::nanoseconds();
+		}
+	}
+	void Tracer::setTracingEntities(bool tracing) {
+		_isTracingEntities = tracing;
+	}
+	unsigned long Tracer::getEventCount() {
+		unsigned long count = 0;
+		pthread_mutex_lock(&_buffersMutex);
+		for(std::vector<TraceBuffer*>::iterator i = _buffers.begin(); i != _buffers.end(); i++) {
+			count += (*i)->size;
+		}
+		pthread_mutex_unlock(&_buffersMutex);
+		return count;
+	}
+	unsigned long Tracer::getDroppedCount() {
+		unsigned long count = 0;
+		pthread_mutex_lock(&_buffersMutex);
+		for(std::vector<TraceBuffer*>::iterator i = _buffers.begin(); i != _buffers.end(); i++) {
+			count += (*i)->dropped;
+		}
+		pthread_mutex_unlock(&_buffersMutex);
+		return count;
+	}
+	void Tracer::writeChromeTrace(std::ostream& out) {
+		stop();
+		double micros_per_tick = 1e-3;
+		if(_stopTicks > _startTicks) {
+			micros_per_tick = (_stopNanos - _startNanos) * 1e-3 / (double)(_stopTicks - _startTicks);
+		}
+		std::vector<std::string> names;
+		pthread_mutex_lock(&_namesMutex);
+		if(_names != 0) {
+			names = *_names;
+		}
+		pthread_mutex_unlock(&_namesMutex);
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::fixed << std::setprecision(3);
+		bool first = true;
+		pthread_mutex_lock(&_buffersMutex);
+		for(std::vector<TraceBuffer*>::iterator b = _buffers.begin(); b != _buffers.end(); b++) {
+			const TraceBuffer* buffer = *b;
+			if(buffer->size == 0) {
+				continue;
+			}
+			out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+				<< buffer->thread << ",\"args\":{\"name\":\"thread " << buffer->thread << "\"}}";
+			first = false;
+			// markers of scopes that straddle start() or a full buffer are unmatched:
+			// drop the dangling ends, and close the open scopes at the last timestamp
+			std::vector<uint32_t> open;
+			double ts = 0;
+			for(unsigned int i = 0; i < buffer->size; i++) {
+				const tTraceEvent& event = buffer->events[i];
+				if(event.phase == PHASE_END) {
+					if(open.empty()) {
+						continue;
+					}
+					open.pop_back();
+				} else {
+					open.push_back(event.name);
+				}
+				ts = (int64_t)(event.ticks - _startTicks) * micros_per_tick;
+				out << ",\n{\"name\":";
+				writeJsonString(out, event.name < names.size() ? names[event.name] : "?");
+				out << ",\"ph\":\"" << (event.phase == PHASE_BEGIN ? 'B' : 'E')
+					<< "\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":" << ts << "}";
+			}
+			while(!open.empty()) {
+				out << ",\n{\"name\":";
+				writeJsonString(out, open.back() < names.size() ? names[open.back()] : "?");
+				out << ",\"ph\":\"E\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":" << ts << "}";
+				open.pop_back();
+			}
+		}
+		pthread_mutex_unlock(&_buffersMutex);
+		out << "\n]}\n";
+	}
+	void Tracer::writeChromeTrace(const std::string& filename) {
+		std::ofstream file(filename.c_str());
+		if(file.fail()) {
+			throw std::runtime_error("[cg::Tracer] cannot open '" + filename + "'.");
+		}
+		writeChromeTrace(file);
+		std::ostringstream os;
+		os << "[cg::Tracer] " << getEventCount() << " events written to " << filename;
+		unsigned long dropped = getDroppedCount();
+		if(dropped > 0) {
+			os << ", " << dropped << " dropped";
+		}
+		DebugFile::instance()->writeLine(os.str());
+	}
+}
@@ -0,0 +1,184 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <map>
+#include <ostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Clock.h"
+
+/** CG_TRACE_SCOPE(NAME) traces the rest of the enclosing block as a
+ *  scope named NAME. The name is registered once, on first use.
+ */
+#define CG_TRACE_SCOPE(NAME)\
+	static const uint32_t trace_scope_name = cg::Tracer::getNameId(NAME);\
+	cg::TraceScope trace_scope(trace_scope_name);
+
+namespace cg {
+
+	/** cg::tTraceEvent is one 16 byte trace record: a timestamp in
+	 *  cg::Tracer ticks, the id of a registered name, and whether the
+	 *  named scope begins or ends.
+	 */
+	typedef struct {
+		uint64_t ticks;
+		uint32_t name;
+		uint32_t phase;
+	} tTraceEvent;
+
+	/** cg::TraceBuffer is the preallocated array of trace records of
+	 *  one thread.
+	 */
+	struct TraceBuffer {
+		tTraceEvent* events;
+		unsigned int size, capacity, thread;
+		unsigned long dropped;
+	};
+
+	/** cg::Tracer is a singleton recording begin/end markers of named
+	 *  scopes into per-thread, preallocated binary buffers, so that the
+	 *  structure of frames can be inspected over time. Recording a marker
+	 *  is a timestamp read (the TSC when it is invariant, cg::Clock
+	 *  otherwise) and a store; when tracing is off it is a single test.
+	 *  Markers are placed around cg::UpdateNotifier::update,
+	 *  cg::DrawNotifier::draw, cg::DrawOverlayNotifier::drawOverlay and
+	 *  glutSwapBuffers, and, if cg::Tracer::setTracingEntities is on,
+	 *  around each entity callback of these notifiers. When a thread's
+	 *  buffer is full further markers are dropped and counted.
+	 *  cg::Tracer::writeChromeTrace converts the records into Chrome
+	 *  trace_event JSON, to be opened in chrome://tracing or Perfetto.
+	 *  Names are registered once with cg::Tracer::getNameId and live as
+	 *  long as the process, so ids may be cached in static variables.
+	 *  cg::Tracer::start, cg::Tracer::stop and the conversion are meant
+	 *  to be called from the main thread.
+	 */
+	class Tracer {
+
+	public:
+		static const unsigned int DEFAULT_CAPACITY = 1 << 20;
+		typedef enum { PHASE_BEGIN, PHASE_END } tPhase;
+
+	private:
+		static Tracer* _instance;
+		Tracer();
+
+		static pthread_mutex_t _namesMutex;
+		static std::vector<std::string>* _names;
+		static std::map<std::string, uint32_t>* _nameIndex;
+
+		pthread_key_t _key;
+		pthread_mutex_t _buffersMutex;
+		std::vector<TraceBuffer*> _buffers;
+		unsigned int _capacity;
+		bool _isRecording, _isTracingEntities, _isUsingTsc;
+		uint64_t _startTicks, _startNanos, _stopTicks, _stopNanos;
+
+		uint64_t ticks() const;
+		TraceBuffer* registerThread();
+		void allocate(TraceBuffer* buffer);
+		void record(uint32_t name, tPhase phase);
+
+	public:
+		static Tracer* instance();
+		virtual ~Tracer();
+		void cleanup();
+
+		static uint32_t getNameId(const std::string& name);
+		static std::string getName(uint32_t id);
+
+		void start(unsigned int capacity = DEFAULT_CAPACITY);
+		void stop();
+		bool isRecording() const;
+		void setTracingEntities(bool tracing);
+		bool isTracingEntities() const;
+
+		void begin(uint32_t name);
+		void end(uint32_t name);
+
+		unsigned long getEventCount();
+		unsigned long getDroppedCount();
+		void writeChromeTrace(std::ostream& out);
+		void writeChromeTrace(const std::string& filename);
+	};
+
+	/** cg::TraceScope records the begin marker of a named scope when
+	 *  constructed, and its end marker when destroyed.
+	 */
+	class TraceScope {
+	private:
+		uint32_t _name;
+	public:
+		TraceScope(uint32_t name) : _name(name) {
+			Tracer::instance()->begin(_name);
+		}
+		~TraceScope() {
+			Tracer::instance()->end(_name);
+		}
+	};
+
+	inline Tracer* Tracer::instance() {
+		if (_instance == 0) {
+			_instance = new Tracer();
+		}
+		return _instance;
+	}
+	inline uint64_t Tracer::ticks() const {
+#if defined(__x86_64__) || defined(__i386__)
+		if(_isUsingTsc) {
+			return __builtin_ia32_rdtsc();
+		}
+#endif
+		return Clock::nanoseconds();
+	}
+	inline void Tracer::record(uint32_t name, tPhase phase) {
+		TraceBuffer* buffer = (TraceBuffer*)pthread_getspecific(_key);
+		if(buffer == 0) {
+			buffer = registerThread();
+		}
+		if(buffer->size < buffer->capacity) {
+			tTraceEvent& event = buffer->events[buffer->size++];
+			event.ticks = ticks();
+			event.name = name;
+			event.phase = phase;
+		} else {
+			buffer->dropped++;
+		}
+	}
+	inline bool Tracer::isRecording() const {
+		return _isRecording;
+	}
+	inline bool Tracer::isTracingEntities() const {
+		return _isRecording && _isTracingEntities;
+	}
+	inline void Tracer::begin(uint32_t name) {
+		if(_isRecording) {
+			record(name, PHASE_BEGIN);
+		}
+	}
+	inline void Tracer::end(uint32_t name) {
+		if(_isRecording) {
+			record(name, PHASE_END);
+		}
+	}
+}
+
+#endif // TRACER_H
@@ -23,6 +23,7 @@ namespace cg {
 	SINGLETON_IMPLEMENTATION(UpdateNotifier)
 
 	void UpdateNotifier::update(unsigned long elapsed_millis) {
-		FOR_EACH_LISTENER(update(elapsed_millis))
+		CG_TRACE_SCOPE("update")
+		FOR_EACH_LISTENER_PROFILED(update(elapsed_millis), "update")
 	}
 }
@@ -18,6 +18,11 @@
 
 #include "Util.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CG_UTIL_X86
+#endif
+
 namespace cg {
 
     SINGLETON_IMPLEMENTATION(Util)
@@ -35,10 +40,9 @@ namespace cg {
             y += delta;
         }
     }
+    // Milliseconds of the monotonic cg::Clock: only meaningful as differences.
     unsigned long Util::getSystemTime() {
-        struct timeb current_time;
-        ftime(&current_time);
-        return (current_time.time * 1000) + current_time.millitm;
+        return Clock::milliseconds();
     }
     void Util::worldToScreenCoordinates(GLdouble wx, GLdouble wy,GLdouble wz, GLdouble *sx, GLdouble *sy, GLdouble *sz) {
 		GLint viewport[4];
@@ -94,4 +98,129 @@ namespace cg {
 		return( projectionDistance(bottomleft0[0],topright0[0],bottomleft1[0],topright1[0]) <= 0
 			 && projectionDistance(bottomleft0[1],topright0[1],bottomleft1[1],topright1[1]) <= 0 );
 	}
+
+	// Batch AABB kernels: the same test as above, written as
+	// min1 <= max0 && min0 <= max1 on each axis (touching boxes collide).
+	typedef void (*tAABBoxBatch)(const float box[4], const float* min_xs, const float* min_ys,
+			const float* max_xs, const float* max_ys, unsigned int begin, unsigned int n, uint32_t* hits);
+
+	static void aabboxBatchScalar(const float box[4], const float* min_xs, const float* min_ys,
+			const float* max_xs, const float* max_ys, unsigned int begin, unsigned int n, uint32_t* hits) {
+		for(unsigned int i = begin; i < n; i++) {
+			if(i % 32 == 0) {
+				hits[i / 32] = 0;
+			}
+			if(min_xs[i] <= box[2] && box[0] <= max_xs[i] && min_ys[i] <= box[3] && box[1] <= max_ys[i]) {
+				hits[i / 32] |= 1u << (i % 32);
+			}
+		}
+	}
+#ifdef CG_UTIL_X86
+	__attribute__((target("sse2")))
+	static void aabboxBatchSSE2(const float box[4], const float* min_xs, const float* min_ys,
+			const float* max_xs, const float* max_ys, unsigned int begin, unsigned int n, uint32_t* hits) {
+		const __m128 minX = _mm_set1_ps(box[0]);
+		const __m128 minY = _mm_set1_ps(box[1]);
+		const __m128 maxX = _mm_set1_ps(box[2]);
+		const __m128 maxY = _mm_set1_ps(box[3]);
+		unsigned int i = begin;
+		for(; i + 32 <= n; i += 32) {
+			uint32_t mask = 0;
+			for(unsigned int j = 0; j < 32; j += 4) {
+				__m128 hit = _mm_and_ps(
+					_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(min_xs + i + j), maxX), _mm_cmple_ps(minX, _mm_loadu_ps(max_xs + i + j))),
+					_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(min_ys + i + j), maxY), _mm_cmple_ps(minY, _mm_loadu_ps(max_ys + i + j))));
+				mask |= (uint32_t)_mm_movemask_ps(hit) << j;
+			}
+			hits[i / 32] = mask;
+		}
+		aabboxBatchScalar(box, min_xs, min_ys, max_xs, max_ys, i, n, hits);
+	}
+	__attribute__((target("avx")))
+	static void aabboxBatchAVX(const float box[4], const float* min_xs, const float* min_ys,
+			const float* max_xs, const float* max_ys, unsigned int begin, unsigned int n, uint32_t* hits) {
+		const __m256 minX = _mm256_set1_ps(box[0]);
+		const __m256 minY = _mm256_set1_ps(box[1]);
+		const __m256 maxX = _mm256_set1_ps(box[2]);
+		const __m256 maxY = _mm256_set1_ps(box[3]);
+		unsigned int i = begin;
+		for(; i + 32 <= n; i += 32) {
+			uint32_t mask = 0;
+			for(unsigned int j = 0; j < 32; j += 8) {
+				__m256 hit = _mm256_and_ps(
+					_mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(min_xs + i + j), maxX, _CMP_LE_OQ),
+								  _mm256_cmp_ps(minX, _mm256_loadu_ps(max_xs + i + j), _CMP_LE_OQ)),
+					_mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(min_ys + i + j), maxY, _CMP_LE_OQ),
+								  _mm256_cmp_ps(minY, _mm256_loadu_ps(max_ys + i + j), _CMP_LE_OQ)));
+				mask |= (uint32_t)_mm256_movemask_ps(hit) << j;
+			}
+			hits[i / 32] = mask;
+		}
+		aabboxBatchScalar(box, min_xs, min_ys, max_xs, max_ys, i, n, hits);
+	}
+#endif
+	typedef struct {
+		const char* name;
+		tAABBoxBatch batch;
+	} tAABBoxKernel;
+
+	// The kernels the CPU supports, slowest first.
+	static std::vector<tAABBoxKernel> supportedAABBoxKernels() {
+		std::vector<tAABBoxKernel> kernels;
+		tAABBoxKernel scalar = { "scalar", aabboxBatchScalar };
+		kernels.push_back(scalar);
+#ifdef CG_UTIL_X86
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("sse2")) {
+			tAABBoxKernel sse2 = { "sse2", aabboxBatchSSE2 };
+			kernels.push_back(sse2);
+		}
+		if(__builtin_cpu_supports("avx")) {
+			tAABBoxKernel avx = { "avx", aabboxBatchAVX };
+			kernels.push_back(avx);
+		}
+#endif
+		return kernels;
+	}
+	static tAABBoxBatch& getAABBoxBatch() {
+		static tAABBoxBatch batch = supportedAABBoxKernels().back().batch;
+		return batch;
+	}
+	// Tests the box [min_x,max_x]x[min_y,max_y] against the n boxes given as
+	// four separate arrays, with the widest SIMD instructions the CPU supports
+	// unless another kernel was set. Sets bit i%32 of hits[i/32] if box i
+	// collides ((n+31)/32 words are written) and returns the number of
+	// collisions.
+	unsigned int Util::isAABBoxCollision(float min_x, float min_y, float max_x, float max_y,
+								 const float* min_xs, const float* min_ys, const float* max_xs, const float* max_ys,
+								 unsigned int n, uint32_t* hits) {
+		const float box[4] = { min_x, min_y, max_x, max_y };
+		getAABBoxBatch()(box, min_xs, min_ys, max_xs, max_ys, 0, n, hits);
+		unsigned int count = 0;
+		for(unsigned int w = 0; w < (n + 31) / 32; w++) {
+			count += __builtin_popcount(hits[w]);
+		}
+		return count;
+	}
+	// Names of the batch AABB kernels the CPU supports, slowest first.
+	std::vector<std::string> Util::getAABBoxKernels() {
+		std::vector<tAABBoxKernel> kernels = supportedAABBoxKernels();
+		std::vector<std::string> names;
+		for(unsigned int i = 0; i < kernels.size(); i++) {
+			names.push_back(kernels[i].name);
+		}
+		return names;
+	}
+	// Selects the batch AABB kernel by name, and returns false if the CPU
+	// does not support it. Not to be called while other threads test boxes.
+	bool Util::setAABBoxKernel(const std::string& name) {
+		std::vector<tAABBoxKernel> kernels = supportedAABBoxKernels();
+		for(unsigned int i = 0; i < kernels.size(); i++) {
+			if(name == kernels[i].name) {
+				getAABBoxBatch() = kernels[i].batch;
+				return true;
+			}
+		}
+		return false;
+	}
 }
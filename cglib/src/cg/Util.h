@@ -19,10 +19,11 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <stdint.h>
 #include <string>
-#include <sys/timeb.h>
 #include <vector>
 #include <GL/glut.h>
+#include "Clock.h"
 #include "Singleton.h"
 #include "Vector.h"
 
@@ -46,6 +47,11 @@ namespace cg {
 		bool isPointInPolygon(const Vector2d& point, std::vector<Vector2d>& polygon);
 		bool isAABBoxCollision(const Vector2d& bottomleft0, const Vector2d& topright0, 
 							   const Vector2d& bottomleft1, const Vector2d& topright1);
+		unsigned int isAABBoxCollision(float min_x, float min_y, float max_x, float max_y,
+							   const float* min_xs, const float* min_ys, const float* max_xs, const float* max_ys,
+							   unsigned int n, uint32_t* hits);
+		std::vector<std::string> getAABBoxKernels();
+		bool setAABBoxKernel(const std::string& name);
     };
 
 }
@@ -22,6 +22,9 @@
 #include <cmath>
 #include <cassert>
 #include <sstream>
+#ifdef CG_VECTOR_EXPRESSIONS
+#include "VectorExpression.h"
+#endif
 
 namespace cg {
 
@@ -32,6 +35,9 @@ namespace cg {
 	 *    cg::Vector3i - 3D vector of integer precision.
 	 *    cg::Vector3f - 3D vector of single precision.
 	 *    cg::Vector3d - 3D vector of double precision.
+	 *  If CG_VECTOR_EXPRESSIONS is defined, the arithmetic operators build
+	 *  expression templates, evaluated without temporaries when assigned
+	 *  (see cg::VectorExpression).
 	 */
 
     const double DEGREES_TO_RADIANS =  0.01745329251994329547;
@@ -42,7 +48,11 @@ namespace cg {
     for(int i=0;i<N;i++){X;}
 
     template<class V, class T, int N>
-    class Vector {
+    class Vector
+#ifdef CG_VECTOR_EXPRESSIONS
+        : public VectorExpression<Vector<V,T,N>,V,T,N>
+#endif
+    {
 
     public:
         T data[N];
@@ -51,6 +61,10 @@ namespace cg {
         Vector(const T x) { for_each_i( data[i] = x ) }
 		Vector(const T v[N]){ for_each_i( data[i] = v[i] ) }
 		Vector(const V& v) { for_each_i( data[i] = v.data[i] ) }
+#ifdef CG_VECTOR_EXPRESSIONS
+		template<class E>
+		Vector(const VectorExpression<E,V,T,N>& e) { for_each_i( data[i] = e.self()[i] ) }
+#endif
 
 		const T& operator[](int i) const { 
 			assert(i<N);
@@ -90,6 +104,16 @@ namespace cg {
 
 		void operator*=(T k) { for_each_i( data[i] *= k ); }
 		void operator/=(T k) { for_each_i( data[i] /= k ); }
+#ifdef CG_VECTOR_EXPRESSIONS
+		template<class E>
+		void operator*=(const VectorExpression<E,V,T,N>& e) { for_each_i( data[i] *= e.self()[i] ); }
+		template<class E>
+		void operator/=(const VectorExpression<E,V,T,N>& e) { for_each_i( data[i] /= e.self()[i] ); }
+		template<class E>
+		void operator+=(const VectorExpression<E,V,T,N>& e) { for_each_i( data[i] += e.self()[i] ); }
+		template<class E>
+		void operator-=(const VectorExpression<E,V,T,N>& e) { for_each_i( data[i] -= e.self()[i] ); }
+#else
 		void operator*=(const V& v) { for_each_i( data[i] *= v[i] ); }
 		void operator/=(const V& v) { for_each_i( data[i] /= v[i] ); }
 		void operator+=(const V& v) { for_each_i( data[i] += v[i] ); }
@@ -135,6 +159,7 @@ namespace cg {
 		    for_each_i( v_new.data[i] = data[i] / k; )
 		    return v_new;
         }
+#endif
 
         //---<stream>---
 
@@ -192,6 +217,15 @@ namespace cg {
 		Vector2(const T k) : Vector<Vector2<T>,T,2>(k) {}
 		Vector2(const T v[2]) : Vector<Vector2<T>,T,2>(v) {}
 		Vector2(const Vector2<T>& v) : Vector<Vector2<T>,T,2>(v) {}
+#ifdef CG_VECTOR_EXPRESSIONS
+		template<class E>
+		Vector2(const VectorExpression<E,Vector2<T>,T,2>& e) : Vector<Vector2<T>,T,2>(e) {}
+		template<class E>
+		Vector2<T>& operator=(const VectorExpression<E,Vector2<T>,T,2>& e) {
+			for(int i = 0; i < 2; i++) Vector<Vector2<T>,T,2>::data[i] = e.self()[i];
+			return *this;
+		}
+#endif
         Vector2(const T x, const T y) {
             Vector<Vector2<T>,T,2>::data[0] = x;
             Vector<Vector2<T>,T,2>::data[1] = y;
@@ -260,6 +294,15 @@ namespace cg {
 		Vector3(const T k) : Vector<Vector3<T>,T,3>(k) {}
 		Vector3(const T v[3]) : Vector<Vector3<T>,T,3>(v) {}
 		Vector3(const Vector3<T>& v) : Vector<Vector3<T>,T,3>(v) {}
+#ifdef CG_VECTOR_EXPRESSIONS
+		template<class E>
+		Vector3(const VectorExpression<E,Vector3<T>,T,3>& e) : Vector<Vector3<T>,T,3>(e) {}
+		template<class E>
+		Vector3<T>& operator=(const VectorExpression<E,Vector3<T>,T,3>& e) {
+			for(int i = 0; i < 3; i++) Vector<Vector3<T>,T,3>::data[i] = e.self()[i];
+			return *this;
+		}
+#endif
         Vector3(const T x, const T y, const T z) {
             Vector<Vector3<T>,T,3>::data[0] = x;
             Vector<Vector3<T>,T,3>::data[1] = y;
@@ -376,6 +419,7 @@ namespace cg {
 	template <class T>
 	const Vector3<T> Vector3<T>::nz(0,0,1);
 
+#ifndef CG_VECTOR_EXPRESSIONS
     //---<multiply by a factor on the left>---
 
     template<class V, class T, int N>
@@ -396,6 +440,7 @@ namespace cg {
         for_each_i( v_new.data[i] = v.data[i] * k; )
         return v_new;
     }
+#endif
 
     //---<predefined>---
 
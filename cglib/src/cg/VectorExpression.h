@@ -0,0 +1,131 @@
+// This file is part of CGLib.
+//
+// CGLib is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// CGLib is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CGLib; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+
+#ifndef VECTOR_EXPRESSION_H
+#define VECTOR_EXPRESSION_H
+
+namespace cg {
+
+	template <class V, class T, int N> class Vector;
+
+	/** Expression templates for cg::Vector, used when cglib is compiled with
+	 *  CG_VECTOR_EXPRESSIONS defined. Every cg::Vector is then a
+	 *  cg::VectorExpression, and the arithmetic operators return lightweight
+	 *  expression objects instead of vectors. An expression is evaluated,
+	 *  component by component and in a single loop, only when it is assigned
+	 *  to (or used to construct) a vector, so
+	 *      _position -= _velocity * elapsed_seconds;
+	 *  creates no temporary vector. Each component is computed with the same
+	 *  operations as the cg::Vector operators, so results do not change.
+	 *  Expressions keep references to the vectors they use, so they must not
+	 *  outlive the statement they appear in.
+	 */
+	template <class E, class V, class T, int N>
+	class VectorExpression {
+	public:
+		typedef T tScalar;
+		const E& self() const { return static_cast<const E&>(*this); }
+	};
+
+	// Vectors are kept by reference, intermediate expressions by value.
+	template <class E>
+	struct VectorOperand { typedef const E type; };
+	template <class V, class T, int N>
+	struct VectorOperand<Vector<V,T,N> > { typedef const Vector<V,T,N>& type; };
+
+	struct VectorAdd { template <class T, class A, class B> static T apply(A a, B b) { return a + b; } };
+	struct VectorSub { template <class T, class A, class B> static T apply(A a, B b) { return a - b; } };
+	struct VectorMul { template <class T, class A, class B> static T apply(A a, B b) { return a * b; } };
+	struct VectorDiv { template <class T, class A, class B> static T apply(A a, B b) { return a / b; } };
+
+	template <class L, class R, class OP, class V, class T, int N>
+	class VectorBinaryExpression : public VectorExpression<VectorBinaryExpression<L,R,OP,V,T,N>,V,T,N> {
+	private:
+		typename VectorOperand<L>::type _l;
+		typename VectorOperand<R>::type _r;
+	public:
+		VectorBinaryExpression(const L& l, const R& r) : _l(l), _r(r) {}
+		T operator[](int i) const { return OP::template apply<T>(_l[i], _r[i]); }
+	};
+
+	template <class E, class S, class OP, class V, class T, int N>
+	class VectorScalarExpression : public VectorExpression<VectorScalarExpression<E,S,OP,V,T,N>,V,T,N> {
+	private:
+		typename VectorOperand<E>::type _e;
+		S _k;
+	public:
+		VectorScalarExpression(const E& e, S k) : _e(e), _k(k) {}
+		T operator[](int i) const { return OP::template apply<T>(_e[i], _k); }
+	};
+
+	template <class E, class V, class T, int N>
+	class VectorNegateExpression : public VectorExpression<VectorNegateExpression<E,V,T,N>,V,T,N> {
+	private:
+		typename VectorOperand<E>::type _e;
+	public:
+		VectorNegateExpression(const E& e) : _e(e) {}
+		T operator[](int i) const { return -_e[i]; }
+	};
+
+	//---<binary>---
+
+#define CG_VECTOR_BINARY_OPERATOR(OPERATOR, OP) \
+	template <class L, class R, class V, class T, int N> \
+	inline const VectorBinaryExpression<L,R,OP,V,T,N> operator OPERATOR( \
+			const VectorExpression<L,V,T,N>& l, const VectorExpression<R,V,T,N>& r) { \
+		return VectorBinaryExpression<L,R,OP,V,T,N>(l.self(), r.self()); \
+	}
+
+	CG_VECTOR_BINARY_OPERATOR(+, VectorAdd)
+	CG_VECTOR_BINARY_OPERATOR(-, VectorSub)
+	CG_VECTOR_BINARY_OPERATOR(*, VectorMul)
+	CG_VECTOR_BINARY_OPERATOR(/, VectorDiv)
+
+	//---<scalar>---
+
+	template <class E, class V, class T, int N>
+	inline const VectorScalarExpression<E,T,VectorMul,V,T,N> operator*(
+			const VectorExpression<E,V,T,N>& e, const typename VectorExpression<E,V,T,N>::tScalar k) {
+		return VectorScalarExpression<E,T,VectorMul,V,T,N>(e.self(), k);
+	}
+	template <class E, class V, class T, int N>
+	inline const VectorScalarExpression<E,T,VectorDiv,V,T,N> operator/(
+			const VectorExpression<E,V,T,N>& e, const typename VectorExpression<E,V,T,N>::tScalar k) {
+		return VectorScalarExpression<E,T,VectorDiv,V,T,N>(e.self(), k);
+	}
+
+	//---<multiply by a factor on the left>---
+
+#define CG_VECTOR_LEFT_SCALAR_OPERATOR(S) \
+	template <class E, class V, class T, int N> \
+	inline const VectorScalarExpression<E,S,VectorMul,V,T,N> operator*(S k, const VectorExpression<E,V,T,N>& e) { \
+		return VectorScalarExpression<E,S,VectorMul,V,T,N>(e.self(), k); \
+	}
+
+	CG_VECTOR_LEFT_SCALAR_OPERATOR(double)
+	CG_VECTOR_LEFT_SCALAR_OPERATOR(float)
+	CG_VECTOR_LEFT_SCALAR_OPERATOR(int)
+
+	//---<unary>---
+
+	template <class E, class V, class T, int N>
+	inline const VectorNegateExpression<E,V,T,N> operator-(const VectorExpression<E,V,T,N>& e) {
+		return VectorNegateExpression<E,V,T,N>(e.self());
+	}
+}
+
+#endif // VECTOR_EXPRESSION_H
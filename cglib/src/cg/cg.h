@@ -19,13 +19,20 @@
 #ifndef CG_H
 #define CG_H
 
+#include "AlignedVector.h"
 #include "Application.h"
+#include "Clock.h"
 #include "CommandQueue.h"
+#include "ComponentArray.h"
+#include "ComponentStore.h"
+#include "ComponentSystem.h"
 #include "DebugFile.h"
 #include "DebugNotifier.h"
+#include "DispatchList.h"
 #include "DrawNotifier.h"
 #include "DrawOverlayNotifier.h"
 #include "Entity.h"
+#include "EntityHandle.h"
 #include "Group.h"
 #include "GroupDebug.h"
 #include "GroupDraw.h"
@@ -39,24 +46,37 @@
 #include "IDrawOverlayListener.h"
 #include "IKeyboardEventListener.h"
 #include "IMouseEventListener.h"
+#include "IParallelTask.h"
+#include "IPropertyListener.h"
 #include "IReshapeEventListener.h"
 #include "IUpdateListener.h"
 #include "KeyboardEventNotifier.h"
 #include "KeyBuffer.h"
 #include "LockableOrderedMap.h"
 #include "Manager.h"
+#include "Metrics.h"
+#include "MetricsOverlay.h"
 #include "MouseEventNotifier.h"
 #include "Notifier.h"
+#include "Polygon.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
 #include "Properties.h"
 #include "Quaternion.h"
+#include "QuaternionArray.h"
+#include "Random.h"
 #include "Registry.h"
 #include "ReshapeEventNotifier.h"
 #include "Singleton.h"
+#include "SpatialGrid.h"
 #include "State.h"
 #include "Test.h"
 #include "TestSuite.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
 #include "UpdateNotifier.h"
 #include "Util.h"
 #include "Vector.h"
+#include "VectorExpression.h"
 
 #endif // CG_H